@@ -139,6 +139,14 @@ void initApplication(psrsalsaApplication *application, char *name, char *genusag
   application->fchan_select = -1;
   application->switch_history_cmd_only = 0;
   application->history_cmd_only = 0;
+  application->switch_headercache = 0;
+  application->switch_packed = 0;
+  application->switch_halfprec = 0;
+  application->switch_subintcache = 0;
+  application->subintcache = 0;
+  application->read_in_memory = 2;
+  application->switch_wisdom = 0;
+  application->switch_shiftkernel = 0;
   application->switch_fixseed = 0;
   application->fixseed = 0;
   application->switch_template = 0;
@@ -176,6 +184,7 @@ void terminateApplication(psrsalsaApplication *application)
   freePulselongitudeRegion(&(application->onpulse));
   freePulselongitudeRegion(&(application->onpulse2));
   closePSRData(&(application->template_file), 0, application->verbose_state);
+  fftplan_cleanup(application->verbose_state);
  }
 void printCitationInfo()
 {
@@ -433,7 +442,7 @@ int parse_command_string(verbose_definition verbose, int argc, char **argv, int
 void printApplicationHelp(psrsalsaApplication *application)
 {
   fprintf(stdout, "%s %s\n", application->progname, application->genusage);
-  if(application->switch_iformat || application->switch_oformat || application->switch_formatlist || application->switch_headerlist || application->switch_header || application->switch_filelist || application->switch_noweights || application->switch_useweights || application->switch_uniformweights || application->switch_history_cmd_only || application->switch_ext || application->switch_output || application->switch_forceUniformFreqLabelling
+  if(application->switch_iformat || application->switch_oformat || application->switch_formatlist || application->switch_headerlist || application->switch_header || application->switch_filelist || application->switch_noweights || application->switch_useweights || application->switch_uniformweights || application->switch_history_cmd_only || application->switch_headercache || application->switch_packed || application->switch_halfprec || application->switch_subintcache || application->switch_ext || application->switch_output || application->switch_forceUniformFreqLabelling
 ) {
     fprintf(stdout, "\nGeneral Input/Output options:\n");
     if(application->switch_filelist) {
@@ -454,6 +463,12 @@ void printApplicationHelp(psrsalsaApplication *application)
       fprintf(stdout, "  -iformat id       Specify input format (e.g.  -iformat PSRFITS)\n");
     if(application->switch_oformat)
       fprintf(stdout, "  -oformat id       Specify output format (e.g. -oformat PSRFITS)\n");
+    if(application->switch_oformat)
+      fprintf(stdout, "  -compress         Write PSRSALSA binary output in compressed chunks\n");
+    if(application->switch_oformat) {
+      fprintf(stdout, "  -tile \"ns nc\"     Write PSRSALSA binary output in tiles of ns subints and\n");
+      fprintf(stdout, "                    nc channels, for fast access along either axis\n");
+    }
     if(application->switch_headerlist)
       fprintf(stdout, "  -headerlist       Show available parameters for the -header option\n");
     if(application->switch_header)
@@ -475,6 +490,24 @@ void printApplicationHelp(psrsalsaApplication *application)
       fprintf(stdout, "  -history_cmd_only Write the history without timestamp, hence re-running the\n");
       fprintf(stdout, "                    same command might result in identical files.\n");
     }
+    if(application->switch_headercache) {
+      fprintf(stdout, "  -headercache dir  Keep parsed headers in directory dir, so headers of\n");
+      fprintf(stdout, "                    unchanged files are not parsed again in later runs.\n");
+    }
+    if(application->switch_packed) {
+      fprintf(stdout, "  -packed           Keep the quantised samples of PSRFITS input packed in\n");
+      fprintf(stdout, "                    memory, and unpack them only when they are used.\n");
+    }
+    if(application->switch_halfprec) {
+      fprintf(stdout, "  -halfprec type    Keep the input data in memory with 16-bit precision, where\n");
+      fprintf(stdout, "                    type is bfloat16 or float16. Formats which cannot be\n");
+      fprintf(stdout, "                    read subint by subint are loaded as 32-bit floats.\n");
+    }
+    if(application->switch_subintcache) {
+      fprintf(stdout, "  -subintcache MB   Do not load the input data in memory, but read it subint\n");
+      fprintf(stdout, "                    by subint while keeping up to MB megabytes of the most\n");
+      fprintf(stdout, "                    recently used subints in memory.\n");
+    }
   }
   if(application->switch_templatedata || application->switch_align || application->switch_template
      ) {
@@ -488,7 +521,7 @@ void printApplicationHelp(psrsalsaApplication *application)
     if(application->switch_templatedata)
       fprintf(stdout, "  -templatedata file Use this data file as a template profile\n");
   }
-  if(application->switch_polselect || application->switch_rebin || application->switch_nread || application->switch_nskip || application->switch_conshift || application->switch_circshift || application->switch_rot || application->switch_rotdeg || application->switch_tscr || application->switch_TSCR || application->switch_tscr_complete || application->switch_fscr || application->switch_FSCR || application->switch_dedisperse || application->switch_deFaraday || application->switch_stokes || application->switch_coherence || application->switch_changeRefFreq || application->switch_scale || application->switch_debase || application->switch_deparang || application->switch_insertparang || application->switch_norm || application->switch_normglobal || application->switch_fchan || application->switch_blocksize || application->switch_shuffle || application->switch_clip || application->switch_rotateStokes
+  if(application->switch_polselect || application->switch_rebin || application->switch_nread || application->switch_nskip || application->switch_conshift || application->switch_circshift || application->switch_rot || application->switch_rotdeg || application->switch_tscr || application->switch_TSCR || application->switch_tscr_complete || application->switch_fscr || application->switch_FSCR || application->switch_dedisperse || application->switch_deFaraday || application->switch_stokes || application->switch_coherence || application->switch_changeRefFreq || application->switch_scale || application->switch_debase || application->switch_deparang || application->switch_insertparang || application->switch_norm || application->switch_normglobal || application->switch_fchan || application->switch_blocksize || application->switch_shuffle || application->switch_clip || application->switch_rotateStokes || application->switch_shiftkernel
 ) {
     fprintf(stdout, "\nGeneral preprocess options:\n");
     if(application->switch_blocksize)
@@ -559,6 +592,11 @@ void printApplicationHelp(psrsalsaApplication *application)
     }
     if(application->switch_scale)
       fprintf(stdout, "  -scale          \"scale offset\". output = scale*(input+offset)\n");
+    if(application->switch_shiftkernel) {
+      fprintf(stdout, "  -shiftkernel k  Method used to shift profiles when rotating or dedispersing:\n");
+      fprintf(stdout, "                  fourier (default, exact), linear (linear interpolation) or\n");
+      fprintf(stdout, "                  integer (shift by the nearest whole number of bins).\n");
+    }
     if(application->switch_shuffle)
       fprintf(stdout, "  -shuffle        Shuffle the subints in a random order\n");
     if(application->switch_stokes)
@@ -620,7 +658,7 @@ void printApplicationHelp(psrsalsaApplication *application)
    if(application->switch_onpulsegr)
       fprintf(stdout, "  -onpulsegr    Graphically select (additional) onpulse regions\n");
   }
-  if(application->switch_verbose || application->switch_debug || application->switch_nocounters || application->switch_macro || application->switch_fixseed || application->switch_libversions
+  if(application->switch_verbose || application->switch_debug || application->switch_nocounters || application->switch_macro || application->switch_fixseed || application->switch_libversions || application->switch_wisdom
      ) {
     fprintf(stdout, "\nOther general options:\n");
     if(application->switch_verbose)
@@ -636,6 +674,11 @@ void printApplicationHelp(psrsalsaApplication *application)
     if(application->switch_libversions) {
       fprintf(stdout, "  -libversions  Show version information about libraries used by psrsalsa\n");
     }
+    if(application->switch_wisdom) {
+      fprintf(stdout, "  -wisdom file  Measure optimal FFT plans and keep them in this FFTW wisdom\n");
+      fprintf(stdout, "                file, so later runs can reuse them.\n");
+      fprintf(stdout, "  -wisdom_patient file  As -wisdom, but spend more time finding the plans.\n");
+    }
     if(application->switch_macro) {
       fprintf(stdout, "  -macro        Instead of taking commands from keyboard, read them from\n");
       fprintf(stdout, "                this macro file (put a ^ in front of symbol for the ctrl key)\n");
@@ -663,6 +706,18 @@ int processCommandLine(psrsalsaApplication *application, int argc, char **argv,
     if(application->oformat == 0)
       exit(0);
     return 1;
+  }else if(strcmp(argv[*index], "-compress") == 0 && application->switch_oformat) {
+    psrsalsabinary_set_compression(1);
+    return 1;
+  }else if(strcmp(argv[*index], "-tile") == 0 && application->switch_oformat) {
+    long tilesubints, tilechans;
+    if(parse_command_string(application->verbose_state, argc, argv, ++(*index), 0, -1, "%ld %ld", &tilesubints, &tilechans, NULL) == 0 || tilesubints < 1 || tilechans < 1) {
+      fflush(stdout);
+      printerror(application->verbose_state.debug, "Cannot parse '%s' option.", argv[(*index)-1]);
+      exit(0);
+    }
+    psrsalsabinary_set_tiles(tilesubints, tilechans);
+    return 1;
   }else if(strcmp(argv[*index], "-formatlist") == 0 && application->switch_formatlist) {
     fprintf(stdout, "Supported file formats are:\n");
     printPSRDataFormats(stdout, 2);
@@ -878,6 +933,26 @@ int processCommandLine(psrsalsaApplication *application, int argc, char **argv,
   }else if(strcmp(argv[*index], "-noplotsubset") == 0 && application->switch_noplotsubset) {
     application->do_noplotsubset = 1;
     return 1;
+  }else if(strcmp(argv[*index], "-shiftkernel") == 0 && application->switch_shiftkernel) {
+    ++(*index);
+    if(strcmp(argv[*index], "fourier") == 0) {
+      rotate_set_shiftkernel(SHIFTKERNEL_FOURIER);
+    }else if(strcmp(argv[*index], "linear") == 0) {
+      rotate_set_shiftkernel(SHIFTKERNEL_LINEAR);
+    }else if(strcmp(argv[*index], "integer") == 0) {
+      rotate_set_shiftkernel(SHIFTKERNEL_INTEGER);
+    }else {
+      fflush(stdout);
+      printerror(application->verbose_state.debug, "Cannot parse '%s' option, expected fourier, linear or integer.", argv[(*index)-1]);
+      exit(0);
+    }
+    return 1;
+  }else if(strcmp(argv[*index], "-wisdom") == 0 && application->switch_wisdom) {
+    fftplan_set_wisdom(argv[++(*index)], 1, application->verbose_state);
+    return 1;
+  }else if(strcmp(argv[*index], "-wisdom_patient") == 0 && application->switch_wisdom) {
+    fftplan_set_wisdom(argv[++(*index)], 2, application->verbose_state);
+    return 1;
   }else if(strcmp(argv[*index], "-nocounters") == 0 && application->switch_nocounters) {
     application->verbose_state.nocounters = 1;
     return 1;
@@ -1023,6 +1098,32 @@ int processCommandLine(psrsalsaApplication *application, int argc, char **argv,
   }else if(strcmp(argv[*index], "-history_cmd_only") == 0 && application->switch_history_cmd_only) {
     application->history_cmd_only = 1;
     return 1;
+  }else if(strcmp(argv[*index], "-headercache") == 0 && application->switch_headercache) {
+    headercache_set_directory(argv[++(*index)]);
+    return 1;
+  }else if(strcmp(argv[*index], "-packed") == 0 && application->switch_packed) {
+    application->read_in_memory = 3;
+    return 1;
+  }else if(strcmp(argv[*index], "-halfprec") == 0 && application->switch_halfprec) {
+    ++(*index);
+    if(strcmp(argv[*index], "bfloat16") == 0) {
+      application->read_in_memory = 4;
+    }else if(strcmp(argv[*index], "float16") == 0) {
+      application->read_in_memory = 5;
+    }else {
+      fflush(stdout);
+      printerror(application->verbose_state.debug, "Cannot parse '%s' option, expected bfloat16 or float16.", argv[(*index)-1]);
+      exit(0);
+    }
+    return 1;
+  }else if(strcmp(argv[*index], "-subintcache") == 0 && application->switch_subintcache) {
+    if(parse_command_string(application->verbose_state, argc, argv, ++(*index), 0, -1, "%ld", &(application->subintcache), NULL) == 0) {
+      fflush(stdout);
+      printerror(application->verbose_state.debug, "Cannot parse '%s' option.", argv[(*index)-1]);
+      exit(0);
+    }
+    application->read_in_memory = 0;
+    return 1;
   }else {
     return 0;
   }
@@ -1043,10 +1144,21 @@ int getOutputName(psrsalsaApplication *application, char *filename, char *output
   }
   return 1;
 }
+void internal_preprocessApplication_selection(psrsalsaApplication *application, long *chanelnr, long *polnr)
+{
+  *chanelnr = *polnr = -1;
+  if(application->blocksize <= 0) {
+    *chanelnr = application->fchan_select;
+    if(application->dostokes == 0 && application->docoherence == 0 && application->nr_rotateStokes <= 0 && application->do_parang_corr <= 0)
+      *polnr = application->polselectnr;
+  }
+}
 int preprocessApplication(psrsalsaApplication *application, datafile_definition *psrdata)
 {
   datafile_definition clone;
   int device, original_gentype, original_poltype, original_isDeDisp, original_isDeFarad, original_isDePar, original_isDebase;
+  int pulsesselected, chanselected, polselected, scrunched, rebinned;
+  long scrunchrebin;
   double original_freq_ref;
   float x;
   verbose_definition verbose1, verbose2;
@@ -1065,15 +1177,47 @@ int preprocessApplication(psrsalsaApplication *application, datafile_definition
   copyVerboseState(application->verbose_state, &verbose2);
   verbose1.indent = application->verbose_state.indent + 2;
   verbose2.indent = application->verbose_state.indent + 4;
-  if(application->nskip != 0 || application->nread > 0) {
-    if(application->nread <= 0)
-      application->nread = psrdata->NrSubints-application->nskip;
-    if(preprocess_pulsesselect(*psrdata, &clone, application->nskip, application->nread, verbose1) == 0) {
+  pulsesselected = chanselected = polselected = 0;
+  if(psrdata->deferredRead) {
+    long nskip, nread, chanelnr, polnr;
+    nskip = 0;
+    nread = psrdata->NrSubints;
+    if(application->nskip != 0 || application->nread > 0) {
+      if(application->nread <= 0)
+ application->nread = psrdata->NrSubints-application->nskip;
+      nskip = application->nskip;
+      nread = application->nread;
+    }
+    internal_preprocessApplication_selection(application, &chanelnr, &polnr);
+    if(preprocess_hyperslab(*psrdata, &clone, nskip, nread, chanelnr, polnr, verbose1) == 0) {
       fflush(stdout);
-      printerror(application->verbose_state.debug, "preprocessApplication: Error selecting pulses.");
+      printerror(application->verbose_state.debug, "preprocessApplication: Error reading data.");
       return 0;
     }
     swap_orig_clone(psrdata, &clone, application->verbose_state);
+    pulsesselected = 1;
+    if(chanelnr >= 0)
+      chanselected = 1;
+    if(polnr >= 0)
+      polselected = 1;
+  }
+  if(pulsesselected == 0 && (application->nskip != 0 || application->nread > 0)) {
+    if(application->nread <= 0)
+      application->nread = psrdata->NrSubints-application->nskip;
+    if(psrdata->format == MEMORY_format) {
+      if(preprocess_select_inplace(psrdata, application->nskip, application->nread, -1, -1, verbose1) == 0) {
+ fflush(stdout);
+ printerror(application->verbose_state.debug, "preprocessApplication: Error selecting pulses.");
+ return 0;
+      }
+    }else {
+      if(preprocess_pulsesselect(*psrdata, &clone, application->nskip, application->nread, verbose1) == 0) {
+ fflush(stdout);
+ printerror(application->verbose_state.debug, "preprocessApplication: Error selecting pulses.");
+ return 0;
+      }
+      swap_orig_clone(psrdata, &clone, application->verbose_state);
+    }
   }
   if(application->dostokes) {
     if(preprocess_stokes(psrdata, verbose1) == 0)
@@ -1103,15 +1247,9 @@ int preprocessApplication(psrsalsaApplication *application, datafile_definition
       return 0;
     swap_orig_clone(psrdata, &clone, application->verbose_state);
   }
-  if(application->fchan_select != -1) {
-    if(preprocess_channelselect(*psrdata, &clone, application->fchan_select, verbose1) == 0)
+  if((application->fchan_select != -1 && chanselected == 0) || (application->polselectnr >= 0 && polselected == 0)) {
+    if(preprocess_select_inplace(psrdata, 0, psrdata->NrSubints, chanselected ? -1 : application->fchan_select, polselected ? -1 : application->polselectnr, verbose1) == 0)
       return 0;
-    swap_orig_clone(psrdata, &clone, application->verbose_state);
-  }
-  if(application->polselectnr >= 0) {
-    if(preprocess_polselect(*psrdata, &clone, application->polselectnr, verbose1) == 0)
-      return 0;
-    swap_orig_clone(psrdata, &clone, application->verbose_state);
   }
   if(application->newRefFreq > -2) {
     if(preprocess_changeRefFreq(psrdata, application->newRefFreq, verbose1) == 0) {
@@ -1159,11 +1297,6 @@ int preprocessApplication(psrsalsaApplication *application, datafile_definition
       }
     }
   }
-  if(application->dofscr) {
-    if(!preprocess_addsuccessiveFreqChans(*psrdata, &clone, application->dofscr, application->fzapMask, verbose1))
-      return 0;
-    swap_orig_clone(psrdata, &clone, application->verbose_state);
-  }
   if(application->doTSCR) {
     application->dotscr = psrdata->NrSubints;
     if(psrdata->NrSubints <= 0) {
@@ -1172,7 +1305,24 @@ int preprocessApplication(psrsalsaApplication *application, datafile_definition
       return 0;
     }
   }
-  if(application->dotscr) {
+  scrunched = rebinned = 0;
+  scrunchrebin = 0;
+  if(application->dorebin && application->doalign == 0 && application->doshiftphase == 0)
+    scrunchrebin = application->rebin;
+  if((application->dofscr > 0) + (application->dotscr > 0) + (scrunchrebin > 0) >= 2 && application->dofscr >= 0 && application->dotscr >= 0 && psrdata->freqMode == FREQMODE_UNIFORM && (psrdata->NrPols != 4 || psrdata->isDePar != 0)) {
+    if(!preprocess_scrunch(*psrdata, &clone, application->dofscr, application->dotscr, application->tscr_complete, application->fzapMask, scrunchrebin, verbose1))
+      return 0;
+    swap_orig_clone(psrdata, &clone, application->verbose_state);
+    scrunched = 1;
+    if(scrunchrebin > 0)
+      rebinned = 1;
+  }
+  if(application->dofscr && scrunched == 0) {
+    if(!preprocess_addsuccessiveFreqChans(*psrdata, &clone, application->dofscr, application->fzapMask, verbose1))
+      return 0;
+    swap_orig_clone(psrdata, &clone, application->verbose_state);
+  }
+  if(application->dotscr && scrunched == 0) {
     if(!preprocess_addsuccessivepulses(*psrdata, &clone, application->dotscr, application->tscr_complete, verbose1))
       return 0;
     swap_orig_clone(psrdata, &clone, application->verbose_state);
@@ -1264,7 +1414,7 @@ int preprocessApplication(psrsalsaApplication *application, datafile_definition
  return 0;
     }
   }
-  if(application->dorebin) {
+  if(application->dorebin && rebinned == 0) {
     if(!preprocess_rebin(*psrdata, &clone, application->rebin, verbose1))
       return 0;
     swap_orig_clone(psrdata, &clone, application->verbose_state);
@@ -1411,6 +1561,78 @@ int preprocessApplication(psrsalsaApplication *application, datafile_definition
   }
   return 1;
 }
+int preprocessApplication_streamable(psrsalsaApplication *application, datafile_definition psrdata, long *blocksubints, verbose_definition verbose)
+{
+  char *option;
+  long subintsize;
+  option = NULL;
+  if(application->doTSCR)
+    option = "-TSCR";
+  else if(application->doalign)
+    option = "-align";
+  else if(application->doonpulsegr)
+    option = "-onpulsegr";
+  else if(application->do_normglobal)
+    option = "-norm_global";
+  else if(application->doshuffle)
+    option = "-shuffle";
+  else if(application->blocksize > 0)
+    option = "-blocksize";
+  if(option != NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "preprocessApplication_streamable: The %s option requires the whole dataset to be loaded in memory.", option);
+    return 0;
+  }
+  if(psrdata.tsubMode != TSUBMODE_FIXEDTSUB) {
+    fflush(stdout);
+    printerror(verbose.debug, "preprocessApplication_streamable: Preprocessing the data in blocks requires a fixed subintegration duration.");
+    return 0;
+  }
+  subintsize = psrdata.NrBins*psrdata.NrPols*psrdata.NrFreqChan*sizeof(float);
+  *blocksubints = PreprocessStreamingBlockMemory/subintsize;
+  if(*blocksubints < 1)
+    *blocksubints = 1;
+  if(application->dotscr > 1) {
+    *blocksubints -= *blocksubints % application->dotscr;
+    if(*blocksubints < application->dotscr)
+      *blocksubints = application->dotscr;
+  }
+  return 1;
+}
+int preprocessApplication_block(psrsalsaApplication *application, datafile_definition psrdata, long firstsubint, long nrsubints, datafile_definition *block)
+{
+  psrsalsaApplication blockapplication;
+  verbose_definition verbose1;
+  long chanelnr, polnr;
+  copyVerboseState(application->verbose_state, &verbose1);
+  verbose1.indent = application->verbose_state.indent + 2;
+  verbose1.verbose = 0;
+  internal_preprocessApplication_selection(application, &chanelnr, &polnr);
+  if(preprocess_hyperslab(psrdata, block, firstsubint, nrsubints, chanelnr, polnr, verbose1) == 0) {
+    fflush(stdout);
+    printerror(application->verbose_state.debug, "preprocessApplication_block: Error reading subints %ld-%ld.", firstsubint, firstsubint+nrsubints-1);
+    return 0;
+  }
+  readaheadPSRData(&psrdata, firstsubint+nrsubints, nrsubints, verbose1);
+  block->mjd_start = get_mjd_subint(psrdata, firstsubint, verbose1) - 0.5*get_tsub(psrdata, firstsubint, verbose1)/(3600.0*24.0);
+  memcpy(&blockapplication, application, sizeof(psrsalsaApplication));
+  copyVerboseState(verbose1, &(blockapplication.verbose_state));
+  blockapplication.nskip = 0;
+  blockapplication.nread = -1;
+  if(blockapplication.dotscr > nrsubints)
+    blockapplication.dotscr = nrsubints;
+  if(chanelnr >= 0)
+    blockapplication.fchan_select = -1;
+  if(polnr >= 0)
+    blockapplication.polselectnr = -1;
+  if(preprocessApplication(&blockapplication, block) == 0) {
+    fflush(stdout);
+    printerror(application->verbose_state.debug, "preprocessApplication_block: Error preprocessing subints %ld-%ld.", firstsubint, firstsubint+nrsubints-1);
+    closePSRData(block, 0, verbose1);
+    return 0;
+  }
+  return 1;
+}
 int applicationAddFilename(int argi, verbose_definition verbose)
 {
   if(internal_application_cmdline_Nrfilenames < MaxNrApplicationFilenames) {
@@ -22,31 +22,344 @@ void print_fftw_version_used(FILE *stream)
 {
   fprintf(stream, "%s (library)", fftwf_version);
 }
-int rotateSinglepulse(float *data, int npts, float epsilon, verbose_definition verbose)
+static struct {
+  int nx, ny, howmany, direction, inplace, unaligned;
+  fftwf_plan plan;
+}fftplan_cache[FFTPlanCacheSize];
+static int fftplan_cache_nr = 0;
+static int fftplan_cache_next = 0;
+static unsigned fftplan_flags = FFTW_ESTIMATE;
+static char *fftplan_wisdomfile = NULL;
+static float *fftplan_scratchbuf[FFTScratchSlots];
+static long fftplan_scratchsize[FFTScratchSlots];
+static float *fftplan_rampeps = NULL;
+static long fftplan_rampnr = 0;
+static int fftplan_rampnpts = 0;
+static int rotate_shiftkernel = SHIFTKERNEL_FOURIER;
+void fftplan_set_wisdom(char *filename, int planlevel, verbose_definition verbose)
+{
+  if(planlevel >= 2)
+    fftplan_flags = FFTW_PATIENT;
+  else if(planlevel == 1)
+    fftplan_flags = FFTW_MEASURE;
+  else
+    fftplan_flags = FFTW_ESTIMATE;
+  fftplan_wisdomfile = filename;
+  if(filename != NULL) {
+    if(fftwf_import_wisdom_from_filename(filename)) {
+      if(verbose.verbose) {
+ printf("Imported FFTW wisdom from %s\n", filename);
+      }
+    }else if(verbose.debug) {
+      printf("No FFTW wisdom could be imported from %s, it will be created\n", filename);
+    }
+  }
+}
+fftwf_plan internalFFTplan(int nx, int ny, int howmany, int direction, float *in, float *out, verbose_definition verbose)
+{
+  int i, inplace, unaligned;
+  unsigned flags;
+  float *tmpin, *tmpout;
+  fftwf_plan plan;
+  inplace = (in == out);
+  unaligned = (fftwf_alignment_of(in) != 0 || fftwf_alignment_of(out) != 0);
+  for(i = 0; i < fftplan_cache_nr; i++) {
+    if(fftplan_cache[i].nx == nx && fftplan_cache[i].ny == ny && fftplan_cache[i].howmany == howmany && fftplan_cache[i].direction == direction && fftplan_cache[i].inplace == inplace && fftplan_cache[i].unaligned == unaligned)
+      return fftplan_cache[i].plan;
+  }
+  tmpin = (float *)fftwf_malloc(2*(long)howmany*nx*(ny/2+1)*sizeof(float));
+  tmpout = tmpin;
+  if(inplace == 0)
+    tmpout = (float *)fftwf_malloc(2*(long)howmany*nx*(ny/2+1)*sizeof(float));
+  if(tmpin == NULL || tmpout == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalFFTplan: fftwf_malloc failed.");
+    return NULL;
+  }
+  flags = fftplan_flags;
+  if(unaligned)
+    flags |= FFTW_UNALIGNED;
+  if(howmany > 1) {
+    if(direction == FFTW_FORWARD)
+      plan = fftwf_plan_many_dft_r2c(1, &ny, howmany, tmpin, NULL, 1, ny, (fftwf_complex *)tmpout, NULL, 1, ny/2+1, flags);
+    else
+      plan = fftwf_plan_many_dft_c2r(1, &ny, howmany, (fftwf_complex *)tmpin, NULL, 1, ny/2+1, tmpout, NULL, 1, ny, flags);
+  }else if(direction == FFTW_FORWARD) {
+    if(nx == 1)
+      plan = fftwf_plan_dft_r2c_1d(ny, tmpin, (fftwf_complex *)tmpout, flags);
+    else
+      plan = fftwf_plan_dft_r2c_2d(nx, ny, tmpin, (fftwf_complex *)tmpout, flags);
+  }else {
+    if(nx == 1)
+      plan = fftwf_plan_dft_c2r_1d(ny, (fftwf_complex *)tmpin, tmpout, flags);
+    else
+      plan = fftwf_plan_dft_c2r_2d(nx, ny, (fftwf_complex *)tmpin, tmpout, flags);
+  }
+  if(inplace == 0)
+    fftwf_free(tmpout);
+  fftwf_free(tmpin);
+  if(plan == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalFFTplan: Planning a fft of %dx%d points failed.", nx, ny);
+    return NULL;
+  }
+  if(fftplan_cache_nr < FFTPlanCacheSize) {
+    i = fftplan_cache_nr++;
+  }else {
+    i = fftplan_cache_next;
+    fftplan_cache_next = (fftplan_cache_next+1) % FFTPlanCacheSize;
+    fftwf_destroy_plan(fftplan_cache[i].plan);
+  }
+  fftplan_cache[i].nx = nx;
+  fftplan_cache[i].ny = ny;
+  fftplan_cache[i].howmany = howmany;
+  fftplan_cache[i].direction = direction;
+  fftplan_cache[i].inplace = inplace;
+  fftplan_cache[i].unaligned = unaligned;
+  fftplan_cache[i].plan = plan;
+  return plan;
+}
+int fftplan_execute_r2c(int nx, int ny, float *in, float *out, verbose_definition verbose)
+{
+  fftwf_plan plan;
+  plan = internalFFTplan(nx, ny, 1, FFTW_FORWARD, in, out, verbose);
+  if(plan == NULL)
+    return 0;
+  fftwf_execute_dft_r2c(plan, in, (fftwf_complex *)out);
+  return 1;
+}
+int fftplan_execute_c2r(int nx, int ny, float *in, float *out, verbose_definition verbose)
+{
+  fftwf_plan plan;
+  plan = internalFFTplan(nx, ny, 1, FFTW_BACKWARD, in, out, verbose);
+  if(plan == NULL)
+    return 0;
+  fftwf_execute_dft_c2r(plan, (fftwf_complex *)in, out);
+  return 1;
+}
+int fftplan_execute_many_r2c(int npts, int howmany, float *in, float *out, verbose_definition verbose)
+{
+  fftwf_plan plan;
+  plan = internalFFTplan(1, npts, howmany, FFTW_FORWARD, in, out, verbose);
+  if(plan == NULL)
+    return 0;
+  fftwf_execute_dft_r2c(plan, in, (fftwf_complex *)out);
+  return 1;
+}
+int fftplan_execute_many_c2r(int npts, int howmany, float *in, float *out, verbose_definition verbose)
+{
+  fftwf_plan plan;
+  plan = internalFFTplan(1, npts, howmany, FFTW_BACKWARD, in, out, verbose);
+  if(plan == NULL)
+    return 0;
+  fftwf_execute_dft_c2r(plan, (fftwf_complex *)in, out);
+  return 1;
+}
+float *fftplan_scratch(long nrfloats, int slot, verbose_definition verbose)
+{
+  if(fftplan_scratchsize[slot] < nrfloats) {
+    fftwf_free(fftplan_scratchbuf[slot]);
+    fftplan_scratchbuf[slot] = (float *)fftwf_malloc(nrfloats*sizeof(float));
+    if(fftplan_scratchbuf[slot] == NULL) {
+      fftplan_scratchsize[slot] = 0;
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR fftplan_scratch: fftwf_malloc failed.");
+      return NULL;
+    }
+    fftplan_scratchsize[slot] = nrfloats;
+  }
+  return fftplan_scratchbuf[slot];
+}
+void fftplan_cleanup(verbose_definition verbose)
+{
+  int i;
+  if(fftplan_wisdomfile != NULL && fftplan_cache_nr > 0) {
+    if(fftwf_export_wisdom_to_filename(fftplan_wisdomfile) == 0) {
+      fflush(stdout);
+      printwarning(verbose.debug, "WARNING fftplan_cleanup: Cannot write FFTW wisdom to %s", fftplan_wisdomfile);
+    }else if(verbose.debug) {
+      printf("Exported FFTW wisdom to %s\n", fftplan_wisdomfile);
+    }
+  }
+  for(i = 0; i < fftplan_cache_nr; i++)
+    fftwf_destroy_plan(fftplan_cache[i].plan);
+  fftplan_cache_nr = 0;
+  fftplan_cache_next = 0;
+  for(i = 0; i < FFTScratchSlots; i++) {
+    fftwf_free(fftplan_scratchbuf[i]);
+    fftplan_scratchbuf[i] = NULL;
+    fftplan_scratchsize[i] = 0;
+  }
+  free(fftplan_rampeps);
+  fftplan_rampeps = NULL;
+  fftplan_rampnr = 0;
+  fftplan_rampnpts = 0;
+}
+void rotate_set_shiftkernel(int kernel)
+{
+  rotate_shiftkernel = kernel;
+}
+int internalShiftTimedomain(float *data, int npts, float epsilon, int kernel, verbose_definition verbose)
+{
+  long i, j, k, shift;
+  float frac, *tmp;
+  tmp = fftplan_scratch(npts, 0, verbose);
+  if(tmp == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalShiftTimedomain: fftwf_malloc failed.");
+    return 0;
+  }
+  if(kernel == SHIFTKERNEL_INTEGER) {
+    shift = floor(epsilon+0.5);
+    frac = 0;
+  }else {
+    shift = floor(epsilon);
+    frac = epsilon - shift;
+  }
+  shift %= npts;
+  if(shift < 0)
+    shift += npts;
+  memcpy(tmp, data, npts*sizeof(float));
+  if(frac == 0) {
+    memcpy(&data[shift], tmp, (npts-shift)*sizeof(float));
+    memcpy(data, &tmp[npts-shift], shift*sizeof(float));
+  }else {
+    for(i = 0; i < npts; i++) {
+      j = i - shift;
+      if(j < 0)
+ j += npts;
+      k = j - 1;
+      if(k < 0)
+ k += npts;
+      data[i] = (1.0-frac)*tmp[j] + frac*tmp[k];
+    }
+  }
+  return 1;
+}
+int shiftSinglepulse(float *data, int npts, float epsilon, verbose_definition verbose)
+{
+  if(rotate_shiftkernel == SHIFTKERNEL_FOURIER)
+    return rotateSinglepulse(data, npts, epsilon, verbose);
+  return internalShiftTimedomain(data, npts, epsilon, rotate_shiftkernel, verbose);
+}
+void internalPhaseRamp(float *ramp, int npts, double epsilon)
 {
   int i, npts2;
-  float fac, dtheta;
-  fftwf_complex *dataFFT;
-  fftwf_plan plan1, plan2;
+  double dtheta, fac, wr, wi, wpr, wpi, wtemp;
   npts2 = npts/2+1;
-  dataFFT = (fftwf_complex *)fftwf_malloc(npts2*sizeof(fftwf_complex));
-  if(dataFFT == NULL) {
+  fac = 1.0/(double)npts;
+  dtheta = -2.0*M_PI*epsilon/(double)npts;
+  wtemp = sin(0.5*dtheta);
+  wpr = -2.0*wtemp*wtemp;
+  wpi = sin(dtheta);
+  wr = 1.0;
+  wi = 0.0;
+  for(i = 0; i < npts2; i++) {
+    if(i % PhaseRampAnchor == 0 && i != 0) {
+      wr = cos(i*dtheta);
+      wi = sin(i*dtheta);
+    }
+    ramp[2*i] = fac*wr;
+    ramp[2*i+1] = fac*wi;
+    wtemp = wr;
+    wr += wr*wpr - wi*wpi;
+    wi += wi*wpr + wtemp*wpi;
+  }
+}
+void internalApplyPhaseRamp(float *spec, float *ramp, int npts2)
+{
+  int i;
+  float re, im;
+  for(i = 0; i < npts2; i++) {
+    re = spec[2*i]*ramp[2*i] - spec[2*i+1]*ramp[2*i+1];
+    im = spec[2*i]*ramp[2*i+1] + spec[2*i+1]*ramp[2*i];
+    spec[2*i] = re;
+    spec[2*i+1] = im;
+  }
+}
+int rotateSinglepulse(float *data, int npts, float epsilon, verbose_definition verbose)
+{
+  int npts2;
+  float *dataFFT, *ramp;
+  if(epsilon == floor(epsilon))
+    return internalShiftTimedomain(data, npts, epsilon, SHIFTKERNEL_INTEGER, verbose);
+  npts2 = npts/2+1;
+  dataFFT = fftplan_scratch(2*npts2, 0, verbose);
+  ramp = fftplan_scratch(2*npts2, 1, verbose);
+  if(dataFFT == NULL || ramp == NULL) {
     fflush(stdout);
     printerror(verbose.debug, "ERROR rotateSinglepulse: fftwf_malloc failed.");
     return 0;
   }
-  plan1 = fftwf_plan_dft_r2c_1d(npts, data, dataFFT, FFTW_ESTIMATE);
-  plan2 = fftwf_plan_dft_c2r_1d(npts, dataFFT, data, FFTW_ESTIMATE);
-  fftwf_execute(plan1);
-  fac = 1.0/(float)npts;
-  dtheta = -2.0*M_PI*epsilon/(float)npts;
-  for (i=0; i < npts2; i++) {
-    dataFFT[i] *= fac*(cos(i*dtheta) + I*sin(i*dtheta));
+  if(fftplan_execute_r2c(1, npts, data, dataFFT, verbose) == 0)
+    return 0;
+  internalPhaseRamp(ramp, npts, epsilon);
+  internalApplyPhaseRamp(dataFFT, ramp, npts2);
+  if(fftplan_execute_c2r(1, npts, dataFFT, data, verbose) == 0)
+    return 0;
+  return 1;
+}
+int rotateSinglepulseBatch(float *data, int npts, int nrprofiles, int nrpershift, float *epsilon, verbose_definition verbose)
+{
+  int j, s, nrshifts, npts2;
+  float *spectrum, *ramps, *ramp;
+  npts2 = npts/2+1;
+  nrshifts = (nrprofiles+nrpershift-1)/nrpershift;
+  spectrum = fftplan_scratch(2*(long)npts2*nrprofiles, 2, verbose);
+  ramps = fftplan_scratch(2*(long)npts2*nrshifts, 3, verbose);
+  if(spectrum == NULL || ramps == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR rotateSinglepulseBatch: fftwf_malloc failed.");
+    return 0;
+  }
+  if(fftplan_rampnr < nrshifts || fftplan_rampnpts != npts) {
+    free(fftplan_rampeps);
+    fftplan_rampeps = (float *)malloc(nrshifts*sizeof(float));
+    if(fftplan_rampeps == NULL) {
+      fftplan_rampnr = 0;
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR rotateSinglepulseBatch: Memory allocation error.");
+      return 0;
+    }
+    for(s = 0; s < nrshifts; s++)
+      fftplan_rampeps[s] = NAN;
+    fftplan_rampnr = nrshifts;
+    fftplan_rampnpts = npts;
+  }
+  for(s = 0; s < nrshifts; s++) {
+    ramp = &ramps[2*(long)npts2*s];
+    if(fftplan_rampeps[s] == epsilon[s])
+      continue;
+    if(s > 0 && epsilon[s] == epsilon[s-1]) {
+      memcpy(ramp, ramp-2*npts2, 2*npts2*sizeof(float));
+    }else {
+      internalPhaseRamp(ramp, npts, epsilon[s]);
+    }
+    fftplan_rampeps[s] = epsilon[s];
+  }
+  if(fftplan_execute_many_r2c(npts, nrprofiles, data, spectrum, verbose) == 0)
+    return 0;
+  for(j = 0; j < nrprofiles; j++)
+    internalApplyPhaseRamp(&spectrum[2*(long)npts2*j], &ramps[2*(long)npts2*(j/nrpershift)], npts2);
+  if(fftplan_execute_many_c2r(npts, nrprofiles, spectrum, data, verbose) == 0)
+    return 0;
+  return 1;
+}
+int shiftSinglepulseBatch(float *data, int npts, int nrprofiles, int nrpershift, float *epsilon, verbose_definition verbose)
+{
+  int j, kernel;
+  kernel = rotate_shiftkernel;
+  if(kernel == SHIFTKERNEL_FOURIER) {
+    for(j = 0; j < nrprofiles; j += nrpershift) {
+      if(epsilon[j/nrpershift] != floor(epsilon[j/nrpershift]))
+ return rotateSinglepulseBatch(data, npts, nrprofiles, nrpershift, epsilon, verbose);
+    }
+    kernel = SHIFTKERNEL_INTEGER;
+  }
+  for(j = 0; j < nrprofiles; j++) {
+    if(internalShiftTimedomain(&data[(long)npts*j], npts, epsilon[j/nrpershift], kernel, verbose) == 0)
+      return 0;
   }
-  fftwf_execute(plan2);
-  fftwf_destroy_plan(plan1);
-  fftwf_destroy_plan(plan2);
-  fftwf_free(dataFFT);
   return 1;
 }
 int crosscorrelation_fft(float *data1, float *data2, int ndata, float *cc, verbose_definition verbose)
@@ -54,30 +367,22 @@ int crosscorrelation_fft(float *data1, float *data2, int ndata, float *cc, verbo
   int i, npts2;
   float fac;
   fftwf_complex *dataFFT1, *dataFFT2;
-  fftwf_plan plan1, plan2, plan3;
   npts2 = ndata/2+1;
-  dataFFT1 = (fftwf_complex *)fftwf_malloc(npts2*sizeof(fftwf_complex));
-  dataFFT2 = (fftwf_complex *)fftwf_malloc(npts2*sizeof(fftwf_complex));
+  dataFFT1 = (fftwf_complex *)fftplan_scratch(2*npts2, 0, verbose);
+  dataFFT2 = (fftwf_complex *)fftplan_scratch(2*npts2, 1, verbose);
   if(dataFFT1 == NULL || dataFFT2 == NULL) {
     fflush(stdout);
     printerror(verbose.debug, "ERROR crosscorrelation_fft: fftwf_malloc failed.");
     return 0;
   }
-  plan1 = fftwf_plan_dft_r2c_1d(ndata, data1, dataFFT1, FFTW_ESTIMATE);
-  plan2 = fftwf_plan_dft_r2c_1d(ndata, data2, dataFFT2, FFTW_ESTIMATE);
-  plan3 = fftwf_plan_dft_c2r_1d(ndata, dataFFT1, cc, FFTW_ESTIMATE);
-  fftwf_execute(plan1);
-  fftwf_execute(plan2);
+  if(fftplan_execute_r2c(1, ndata, data1, (float *)dataFFT1, verbose) == 0 || fftplan_execute_r2c(1, ndata, data2, (float *)dataFFT2, verbose) == 0)
+    return 0;
   fac = 1.0/(float)ndata;
   for (i=0; i < npts2; i++) {
     dataFFT1[i] *= fac*conj(dataFFT2[i]);
   }
-  fftwf_execute(plan3);
-  fftwf_destroy_plan(plan1);
-  fftwf_destroy_plan(plan2);
-  fftwf_destroy_plan(plan3);
-  fftwf_free(dataFFT1);
-  fftwf_free(dataFFT2);
+  if(fftplan_execute_c2r(1, ndata, (float *)dataFFT1, cc, verbose) == 0)
+    return 0;
   return 1;
 }
 int crosscorrelation_fft_padding_cclength(int ndata, int extrazeropad)
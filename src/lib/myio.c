@@ -361,24 +361,16 @@ int ascii_file_stats(FILE *fin, char skipChar, long *nrlines, int maxlinelength,
   free(txt);
   return 1;
 }
-int read_ascii_column(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, double scale, int read_log, float **data, float *mindata, float *maxdata, float *avdata, verbose_definition verbose, int verbose_stderr)
+int ascii_file_split_columns(char *fname, int skiplines, char skipChar, int *nrColumns, int autoNrColumns, long *nrdatapoints, int nrcolnums, int *colnums, char **buffer, char ***words, char *funcname, verbose_definition verbose, FILE *verbose_stream)
 {
-  FILE *fin, *verbose_stream;
-  long i, j, n, fpos, maxlinelength, linenr;
-  int nrwords, ret;
-  char *txt, *word_ptr;
-  double minx, maxx, sumx;
-  maxlinelength = 10240+1;
-  if(verbose_stderr) {
-    fflush(stdout);
-    verbose_stream = stderr;
-  }else {
-    verbose_stream = stdout;
-  }
+  FILE *fin;
+  long i, size, allocated, nrlines, linenr, n;
+  int c, nrwords;
+  char *ptr, *end, *line_end, *word, *newbuffer;
   fin = fopen(fname, "r");
   if(fin == NULL) {
     fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column: Cannot open %s", fname);
+    printerror(verbose.debug, "%s: Cannot open %s", funcname, fname);
     return 0;
   }else {
     if(verbose.verbose) {
@@ -388,24 +380,113 @@ int read_ascii_column(char *fname, int skiplines, char skipChar, int nrColumns,
       fprintf(verbose_stream, "Opened file '%s'\n", fname);
     }
   }
-  if(skipLinesInFile(fin, skiplines, verbose) == 0) {
+  allocated = 1048576;
+  size = 0;
+  *buffer = malloc(allocated+1);
+  if(*buffer == NULL) {
     fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column: Reached EOF while skipping first %d lines", skiplines);
+    printerror(verbose.debug, "%s: Cannot allocate temporary memory", funcname);
+    fclose(fin);
     return 0;
   }
-  fpos = ftell(fin);
-  txt = malloc(maxlinelength);
-  if(txt == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column: Cannot allocate temporary memory");
-    return 0;
+  while((i = fread(*buffer+size, 1, allocated-size, fin)) > 0) {
+    size += i;
+    if(size == allocated) {
+      allocated *= 2;
+      newbuffer = realloc(*buffer, allocated+1);
+      if(newbuffer == NULL) {
+ fflush(stdout);
+ printerror(verbose.debug, "%s: Cannot allocate temporary memory", funcname);
+ free(*buffer);
+ fclose(fin);
+ return 0;
+      }
+      *buffer = newbuffer;
+    }
   }
-  if(ascii_file_stats(fin, skipChar, nrdatapoints, maxlinelength, autoNrColumns, &nrColumns, verbose) == 0) {
+  fclose(fin);
+  (*buffer)[size] = 0;
+  ptr = *buffer;
+  end = *buffer+size;
+  for(i = 0; i < skiplines; i++) {
+    ptr = memchr(ptr, '\n', end-ptr);
+    if(ptr == NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "%s: Reached EOF while skipping first %d lines", funcname, skiplines);
+      free(*buffer);
+      return 0;
+    }
+    ptr++;
+  }
+  nrlines = 1;
+  for(line_end = ptr; (line_end = memchr(line_end, '\n', end-line_end)) != NULL; line_end++)
+    nrlines++;
+  *words = (char **)malloc(nrlines*(nrcolnums+1)*sizeof(char *));
+  if(*words == NULL) {
     fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column: Error in determining the nr of lines");
-    free(txt);
+    printerror(verbose.debug, "%s: Memory allocation error", funcname);
+    free(*buffer);
     return 0;
   }
+  n = 0;
+  linenr = skiplines;
+  while(ptr < end) {
+    line_end = memchr(ptr, '\n', end-ptr);
+    if(line_end == NULL)
+      line_end = end;
+    *line_end = 0;
+    linenr++;
+    if(*ptr != skipChar) {
+      for(c = 0; c < nrcolnums; c++)
+ (*words)[n*nrcolnums+c] = NULL;
+      nrwords = 0;
+      do {
+ while(*ptr == ' ' || *ptr == '\t' || *ptr == '\r')
+   ptr++;
+ if(*ptr == 0)
+   break;
+ nrwords++;
+ word = ptr;
+ while(*ptr != 0 && *ptr != ' ' && *ptr != '\t' && *ptr != '\r')
+   ptr++;
+ if(*ptr != 0)
+   *(ptr++) = 0;
+ for(c = 0; c < nrcolnums; c++) {
+   if(colnums[c] == nrwords)
+     (*words)[n*nrcolnums+c] = word;
+ }
+      }while(1);
+      if(nrwords > 0) {
+ if(autoNrColumns != 0 && n == 0) {
+   *nrColumns = nrwords;
+ }else if(*nrColumns >= 0 && *nrColumns != nrwords) {
+   fflush(stdout);
+   printerror(verbose.debug, "%s: Nr of columns on line %ld is not the expected %d. Possibly the number of columns is changing from line to line?", funcname, linenr, *nrColumns);
+   free(*words);
+   free(*buffer);
+   return 0;
+ }else if(*nrColumns < 0 && nrwords < -(*nrColumns)) {
+   fflush(stdout);
+   printerror(verbose.debug, "%s: Nr of columns on line %ld is smaller than the expected %d. Possibly the number of columns is changing from line to line?", funcname, linenr, *nrColumns);
+   free(*words);
+   free(*buffer);
+   return 0;
+ }
+ for(c = 0; c < nrcolnums; c++) {
+   if((*words)[n*nrcolnums+c] == NULL) {
+     fflush(stdout);
+     printerror(verbose.debug, "%s: Cannot find column %d on line %ld", funcname, colnums[c], linenr);
+     free(*words);
+     free(*buffer);
+     return 0;
+   }
+ }
+ n++;
+      }
+    }
+    ptr = line_end+1;
+  }
+  *nrdatapoints = n;
   if(verbose.verbose) {
     for(i = 0; i < verbose.indent; i++)
       printf(" ");
@@ -414,68 +495,67 @@ int read_ascii_column(char *fname, int skiplines, char skipChar, int nrColumns,
     if(autoNrColumns) {
       for(i = 0; i < verbose.indent; i++)
  printf(" ");
-      fprintf(verbose_stream, "  There are %d columns\n", nrColumns);
+      fprintf(verbose_stream, "  There are %d columns\n", *nrColumns);
     }
   }
+  return 1;
+}
+int read_ascii_column(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, double scale, int read_log, float **data, float *mindata, float *maxdata, float *avdata, verbose_definition verbose, int verbose_stderr)
+{
+  FILE *verbose_stream;
+  long i, n;
+  char *buffer, **words, *endptr;
+  double minx, maxx, sumx;
+  if(verbose_stderr) {
+    fflush(stdout);
+    verbose_stream = stderr;
+  }else {
+    verbose_stream = stdout;
+  }
+  if(ascii_file_split_columns(fname, skiplines, skipChar, &nrColumns, autoNrColumns, nrdatapoints, 1, &colnum, &buffer, &words, "read_ascii_column", verbose, verbose_stream) == 0) {
+    return 0;
+  }
   *data = (float *)malloc((*nrdatapoints)*sizeof(float));
   if(*data == NULL) {
     fflush(stdout);
     printerror(verbose.debug, "read_ascii_column: Memory allocation error");
-    free(txt);
+    free(words);
+    free(buffer);
     return 0;
   }
-  fseek(fin, fpos, SEEK_SET);
   minx = maxx = NAN;
   sumx = 0;
-  n = 0;
-  linenr = 0;
-  do {
-    ret = ascii_file_get_next_line(fin, txt, maxlinelength, skipChar, verbose);
-    if(ret != 0) {
-      linenr += ret;
-      word_ptr = pickWordFromString(txt, colnum, &nrwords, 1, ' ', verbose);
-      if(n >= *nrdatapoints) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column: Nr of lines in file changed?????");
- free(txt);
- free(*data);
- return 0;
-      }
-      if(word_ptr == NULL) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column: Cannot find column %d on line %ld", colnum, linenr);
- free(txt);
- free(*data);
- return 0;
-      }
-      j = sscanf(word_ptr, "%f", &((*data)[n]));
-      if(j != 1) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column: Cannot interpret column %d on line %ld as a float", colnum, linenr);
- free(txt);
+  for(n = 0; n < *nrdatapoints; n++) {
+    (*data)[n] = strtof(words[n], &endptr);
+    if(endptr == words[n]) {
+      fflush(stdout);
+      printerror(verbose.debug, "read_ascii_column: Cannot interpret column %d ('%s') as a float", colnum, words[n]);
+      free(words);
+      free(buffer);
+      free(*data);
+      return 0;
+    }
+    (*data)[n] *= scale;
+    if(read_log) {
+      if((*data)[n] <= 0) {
+ printerror(verbose.debug, "read_ascii_column: Cannot take logarithm of a value <= 0");
+ free(words);
+ free(buffer);
  free(*data);
  return 0;
       }
-      (*data)[n] *= scale;
-      if(read_log) {
- if((*data)[n] <= 0) {
-   printerror(verbose.debug, "read_ascii_column: Cannot take logarithm of a value <= 0");
-   return 0;
- }
- (*data)[n] = log10((*data)[n]);
-      }
-      if((*data)[n] < minx || n == 0) {
- minx = (*data)[n];
-      }
-      if((*data)[n] > maxx || n == 0) {
- maxx = (*data)[n];
-      }
-      sumx += (*data)[n];
-      n++;
+      (*data)[n] = log10((*data)[n]);
     }
-  }while(ret != 0);
-  free(txt);
-  fclose(fin);
+    if((*data)[n] < minx || n == 0) {
+      minx = (*data)[n];
+    }
+    if((*data)[n] > maxx || n == 0) {
+      maxx = (*data)[n];
+    }
+    sumx += (*data)[n];
+  }
+  free(words);
+  free(buffer);
   if(verbose.verbose) {
     fflush(stdout);
     for(i = 0; i < verbose.indent; i++)
@@ -494,246 +574,138 @@ int read_ascii_column(char *fname, int skiplines, char skipChar, int nrColumns,
     *avdata = sumx/(double)(*nrdatapoints);
   return 1;
 }
-int read_ascii_column_double(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, double scale, int read_log, double **data, double *mindata, double *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr)
+int read_ascii_columns_double(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int nrcolnums, int *colnums, double scale, int read_log, double **data, double *mindata, double *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr)
 {
-  FILE *fin, *verbose_stream;
-  long i, j, n, fpos, maxlinelength, linenr;
-  int nrwords, ret;
-  char *txt, *word_ptr;
+  FILE *verbose_stream;
+  long i, n;
+  int c;
+  char *buffer, **words, *endptr;
   double minx, maxx, sumx;
-  maxlinelength = 10240+1;
   if(verbose_stderr) {
     fflush(stdout);
     verbose_stream = stderr;
   }else {
     verbose_stream = stdout;
   }
-  fin = fopen(fname, "r");
-  if(fin == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_double: Cannot open %s", fname);
-    return 0;
-  }else {
-    if(verbose.verbose) {
-      for(i = 0; i < verbose.indent; i++)
- printf(" ");
-      fflush(stdout);
-      fprintf(verbose_stream, "Opened file '%s'\n", fname);
-    }
-  }
-  if(skipLinesInFile(fin, skiplines, verbose) == 0) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_double: Reached EOF while skipping first %d lines", skiplines);
-    return 0;
-  }
-  fpos = ftell(fin);
-  txt = malloc(maxlinelength);
-  if(txt == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_double: Cannot allocate temporary memory");
-    return 0;
-  }
-  if(ascii_file_stats(fin, skipChar, nrdatapoints, maxlinelength, autoNrColumns, &nrColumns, verbose) == 0) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_double: Error in determining the nr of lines");
-    free(txt);
+  if(ascii_file_split_columns(fname, skiplines, skipChar, &nrColumns, autoNrColumns, nrdatapoints, nrcolnums, colnums, &buffer, &words, "read_ascii_columns_double", verbose, verbose_stream) == 0) {
     return 0;
   }
-  if(verbose.verbose) {
-    for(i = 0; i < verbose.indent; i++)
-      printf(" ");
-    fflush(stdout);
-    fprintf(verbose_stream, "  There are %ld datapoints\n", *nrdatapoints);
-    if(autoNrColumns) {
-      for(i = 0; i < verbose.indent; i++)
- printf(" ");
-      fprintf(verbose_stream, "  There are %d columns\n", nrColumns);
+  for(c = 0; c < nrcolnums; c++) {
+    data[c] = (double *)malloc((*nrdatapoints)*sizeof(double));
+    if(data[c] == NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "read_ascii_columns_double: Memory allocation error");
+      while(--c >= 0)
+ free(data[c]);
+      free(words);
+      free(buffer);
+      return 0;
     }
   }
-  *data = (double *)malloc((*nrdatapoints)*sizeof(double));
-  if(*data == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_double: Memory allocation error");
-    free(txt);
-    return 0;
-  }
-  fseek(fin, fpos, SEEK_SET);
-  minx = maxx = NAN;
-  sumx = 0;
-  n = 0;
-  linenr = 0;
-  do {
-    ret = ascii_file_get_next_line(fin, txt, maxlinelength, skipChar, verbose);
-    if(ret != 0) {
-      linenr += ret;
-      word_ptr = pickWordFromString(txt, colnum, &nrwords, 1, ' ', verbose);
-      if(n >= *nrdatapoints) {
+  for(c = 0; c < nrcolnums; c++) {
+    minx = maxx = NAN;
+    sumx = 0;
+    for(n = 0; n < *nrdatapoints; n++) {
+      data[c][n] = strtod(words[n*nrcolnums+c], &endptr);
+      if(endptr == words[n*nrcolnums+c]) {
  fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_double: Nr of lines in file changed?????");
- free(txt);
- free(*data);
- return 0;
-      }
-      if(word_ptr == NULL) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_double: Cannot find column %d on line %ld", colnum, linenr);
- free(txt);
- free(*data);
- return 0;
-      }
-      j = sscanf(word_ptr, "%lf", &((*data)[n]));
-      if(j != 1) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_double: Cannot interpret column %d on line %ld as a double", colnum, linenr);
- free(txt);
- free(*data);
+ printerror(verbose.debug, "read_ascii_columns_double: Cannot interpret column %d ('%s') as a double", colnums[c], words[n*nrcolnums+c]);
+ for(c = 0; c < nrcolnums; c++)
+   free(data[c]);
+ free(words);
+ free(buffer);
  return 0;
       }
-      (*data)[n] *= scale;
+      data[c][n] *= scale;
       if(read_log) {
- if((*data)[n] <= 0) {
-   printerror(verbose.debug, "read_ascii_column: Cannot take logarithm of a value <= 0");
+ if(data[c][n] <= 0) {
+   printerror(verbose.debug, "read_ascii_columns_double: Cannot take logarithm of a value <= 0");
+   for(c = 0; c < nrcolnums; c++)
+     free(data[c]);
+   free(words);
+   free(buffer);
    return 0;
  }
- (*data)[n] = log10((*data)[n]);
+ data[c][n] = log10(data[c][n]);
       }
-      if((*data)[n] < minx || n == 0) {
- minx = (*data)[n];
+      if(data[c][n] < minx || n == 0) {
+ minx = data[c][n];
       }
-      if((*data)[n] > maxx || n == 0) {
- maxx = (*data)[n];
+      if(data[c][n] > maxx || n == 0) {
+ maxx = data[c][n];
       }
-      sumx += (*data)[n];
-      n++;
+      sumx += data[c][n];
     }
-  }while(ret != 0);
-  free(txt);
-  fclose(fin);
-  if(verbose.verbose) {
-    fflush(stdout);
-    for(i = 0; i < verbose.indent; i++)
-      printf(" ");
-    fflush(stdout);
-    fprintf(verbose_stream, "  %ld points loaded from %s with values between %lf and %lf\n", *nrdatapoints, fname, minx, maxx);
-    for(i = 0; i < verbose.indent; i++)
-      printf(" ");
-    fprintf(verbose_stream, "  Average value = %lf\n", sumx/(double)(*nrdatapoints));
+    if(verbose.verbose) {
+      fflush(stdout);
+      for(i = 0; i < verbose.indent; i++)
+ printf(" ");
+      fflush(stdout);
+      fprintf(verbose_stream, "  %ld points loaded from column %d of %s with values between %lf and %lf\n", *nrdatapoints, colnums[c], fname, minx, maxx);
+      for(i = 0; i < verbose.indent; i++)
+ printf(" ");
+      fprintf(verbose_stream, "  Average value = %lf\n", sumx/(double)(*nrdatapoints));
+    }
+    if(mindata != NULL)
+      mindata[c] = minx;
+    if(maxdata != NULL)
+      maxdata[c] = maxx;
+    if(avdata != NULL)
+      avdata[c] = sumx/(double)(*nrdatapoints);
   }
-  if(mindata != NULL)
-    *mindata = minx;
-  if(maxdata != NULL)
-    *maxdata = maxx;
-  if(avdata != NULL)
-    *avdata = sumx/(double)(*nrdatapoints);
+  free(words);
+  free(buffer);
   return 1;
 }
+int read_ascii_column_double(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, double scale, int read_log, double **data, double *mindata, double *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr)
+{
+  return read_ascii_columns_double(fname, skiplines, skipChar, nrColumns, autoNrColumns, nrdatapoints, 1, &colnum, scale, read_log, data, mindata, maxdata, avdata, verbose, verbose_stderr);
+}
 int read_ascii_column_int(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, int **data, int *mindata, int *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr)
 {
-  FILE *fin, *verbose_stream;
-  long i, j, n, fpos, maxlinelength, linenr;
-  int nrwords, ret;
-  char *txt, *word_ptr;
+  FILE *verbose_stream;
+  long i, n;
+  char *buffer, **words, *endptr;
   long minx, maxx, sumx;
-  maxlinelength = 10240+1;
   if(verbose_stderr) {
     fflush(stdout);
     verbose_stream = stderr;
   }else {
     verbose_stream = stdout;
   }
-  fin = fopen(fname, "r");
-  if(fin == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_int: Cannot open %s", fname);
-    return 0;
-  }else {
-    if(verbose.verbose) {
-      for(i = 0; i < verbose.indent; i++)
- printf(" ");
-      fflush(stdout);
-      fprintf(verbose_stream, "Opened file '%s'\n", fname);
-    }
-  }
-  if(skipLinesInFile(fin, skiplines, verbose) == 0) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_int: Reached EOF while skipping first %d lines", skiplines);
+  if(ascii_file_split_columns(fname, skiplines, skipChar, &nrColumns, autoNrColumns, nrdatapoints, 1, &colnum, &buffer, &words, "read_ascii_column_int", verbose, verbose_stream) == 0) {
     return 0;
   }
-  fpos = ftell(fin);
-  txt = malloc(maxlinelength);
-  if(txt == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_int: Cannot allocate temporary memory");
-    return 0;
-  }
-  if(ascii_file_stats(fin, skipChar, nrdatapoints, maxlinelength, autoNrColumns, &nrColumns, verbose) == 0) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_int: Error in determining the nr of lines");
-    free(txt);
-    return 0;
-  }
-  if(verbose.verbose) {
-    for(i = 0; i < verbose.indent; i++)
-      printf(" ");
-    fflush(stdout);
-    fprintf(verbose_stream, "  There are %ld datapoints\n", *nrdatapoints);
-    if(autoNrColumns) {
-      for(i = 0; i < verbose.indent; i++)
- printf(" ");
-      fprintf(verbose_stream, "  There are %d columns\n", nrColumns);
-    }
-  }
   *data = (int *)malloc((*nrdatapoints)*sizeof(int));
   if(*data == NULL) {
     fflush(stdout);
     printerror(verbose.debug, "read_ascii_column_int: Memory allocation error");
-    free(txt);
+    free(words);
+    free(buffer);
     return 0;
   }
-  fseek(fin, fpos, SEEK_SET);
   minx = maxx = 0;
   sumx = 0;
-  n = 0;
-  linenr = 0;
-  do {
-    ret = ascii_file_get_next_line(fin, txt, maxlinelength, skipChar, verbose);
-    if(ret != 0) {
-      linenr += ret;
-      word_ptr = pickWordFromString(txt, colnum, &nrwords, 1, ' ', verbose);
-      if(n >= *nrdatapoints) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_int: Nr of lines in file changed?????");
- free(txt);
- free(*data);
- return 0;
-      }
-      if(word_ptr == NULL) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_int: Cannot find column %d on line %ld", colnum, linenr);
- free(txt);
- free(*data);
- return 0;
-      }
-      j = sscanf(word_ptr, "%d", &((*data)[n]));
-      if(j != 1) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_int: Cannot interpret column %d on line %ld as a int", colnum, linenr);
- free(txt);
- free(*data);
- return 0;
-      }
-      if((*data)[n] < minx || n == 0) {
- minx = (*data)[n];
-      }
-      if((*data)[n] > maxx || n == 0) {
- maxx = (*data)[n];
-      }
-      sumx += (*data)[n];
-      n++;
+  for(n = 0; n < *nrdatapoints; n++) {
+    (*data)[n] = strtol(words[n], &endptr, 10);
+    if(endptr == words[n]) {
+      fflush(stdout);
+      printerror(verbose.debug, "read_ascii_column_int: Cannot interpret column %d ('%s') as a int", colnum, words[n]);
+      free(words);
+      free(buffer);
+      free(*data);
+      return 0;
     }
-  }while(ret != 0);
-  free(txt);
-  fclose(fin);
+    if((*data)[n] < minx || n == 0) {
+      minx = (*data)[n];
+    }
+    if((*data)[n] > maxx || n == 0) {
+      maxx = (*data)[n];
+    }
+    sumx += (*data)[n];
+  }
+  free(words);
+  free(buffer);
   if(verbose.verbose) {
     fflush(stdout);
     for(i = 0; i < verbose.indent; i++)
@@ -754,109 +726,39 @@ int read_ascii_column_int(char *fname, int skiplines, char skipChar, int nrColum
 }
 int read_ascii_column_str(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, char ***data, verbose_definition verbose, int verbose_stderr)
 {
-  FILE *fin, *verbose_stream;
-  long i, n, fpos, maxlinelength, linenr;
-  int nrwords, ret;
-  char *txt, *word, *word_ptr;
-  maxlinelength = 10240+1;
+  FILE *verbose_stream;
+  long i, n;
+  char *buffer, **words;
   if(verbose_stderr) {
     fflush(stdout);
     verbose_stream = stderr;
   }else {
     verbose_stream = stdout;
   }
-  fin = fopen(fname, "r");
-  if(fin == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_str: Cannot open %s", fname);
-    return 0;
-  }else {
-    if(verbose.verbose) {
-      for(i = 0; i < verbose.indent; i++)
- printf(" ");
-      fflush(stdout);
-      fprintf(verbose_stream, "Opened file '%s'\n", fname);
-    }
-  }
-  if(skipLinesInFile(fin, skiplines, verbose) == 0) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_str: Reached EOF while skipping first %d lines", skiplines);
-    return 0;
-  }
-  fpos = ftell(fin);
-  txt = malloc(maxlinelength);
-  word = malloc(maxlinelength);
-  if(txt == NULL || word == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_str: Cannot allocate temporary memory");
-    return 0;
-  }
-  if(ascii_file_stats(fin, skipChar, nrdatapoints, maxlinelength, autoNrColumns, &nrColumns, verbose) == 0) {
-    fflush(stdout);
-    printerror(verbose.debug, "read_ascii_column_str: Error in determining the nr of lines");
-    free(txt);
-    free(word);
+  if(ascii_file_split_columns(fname, skiplines, skipChar, &nrColumns, autoNrColumns, nrdatapoints, 1, &colnum, &buffer, &words, "read_ascii_column_str", verbose, verbose_stream) == 0) {
     return 0;
   }
-  if(verbose.verbose) {
-    for(i = 0; i < verbose.indent; i++)
-      printf(" ");
-    fflush(stdout);
-    fprintf(verbose_stream, "  There are %ld datapoints\n", *nrdatapoints);
-    if(autoNrColumns) {
-      for(i = 0; i < verbose.indent; i++)
- printf(" ");
-      fprintf(verbose_stream, "  There are %d columns\n", nrColumns);
-    }
-  }
   *data = (char **)malloc((*nrdatapoints)*sizeof(char *));
   if(*data == NULL) {
     fflush(stdout);
     printerror(verbose.debug, "read_ascii_column_str: Memory allocation error");
-    free(word);
-    free(txt);
+    free(words);
+    free(buffer);
     return 0;
   }
-  fseek(fin, fpos, SEEK_SET);
-  n = 0;
-  linenr = 0;
-  do {
-    ret = ascii_file_get_next_line(fin, txt, maxlinelength, skipChar, verbose);
-    if(ret != 0) {
-      linenr += ret;
-      word_ptr = pickWordFromString(txt, colnum, &nrwords, 1, ' ', verbose);
-      if(n >= *nrdatapoints) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_str: Nr of lines in file changed?????");
- free(word);
- free(txt);
- free(*data);
- return 0;
-      }
-      if(word_ptr == NULL) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_str: Cannot find column %d on line %ld", colnum, linenr);
- free(word);
- free(txt);
- free(*data);
- return 0;
-      }
-      sscanf(word_ptr, "%s", word);
-      (*data)[n] = (char *)malloc(strlen(word)+1);
-      if((*data)[n] == NULL) {
- fflush(stdout);
- printerror(verbose.debug, "read_ascii_column_str: Memory allocation error");
- free(word);
- free(txt);
- return 0;
-      }
-      strcpy((*data)[n], word);
-      n++;
+  for(n = 0; n < *nrdatapoints; n++) {
+    (*data)[n] = (char *)malloc(strlen(words[n])+1);
+    if((*data)[n] == NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "read_ascii_column_str: Memory allocation error");
+      free(words);
+      free(buffer);
+      return 0;
     }
-  }while(ret != 0);
-  free(word);
-  free(txt);
-  fclose(fin);
+    strcpy((*data)[n], words[n]);
+  }
+  free(words);
+  free(buffer);
   if(verbose.verbose) {
     fflush(stdout);
     for(i = 0; i < verbose.indent; i++)
@@ -19,6 +19,10 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #include <math.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include "psrsalsa.h"
 int readWSRTHeader(datafile_definition *datafile, verbose_definition verbose);
 int readPulseWSRTData(datafile_definition datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse);
@@ -26,9 +30,14 @@ int writePulseWSRTData(datafile_definition datafile, long pulsenr, int polarizat
 int writeWSRTHeader(datafile_definition datafile, verbose_definition verbose);
 int writePuMafile(datafile_definition datafile, float *data, verbose_definition verbose);
 int readPuMafile(datafile_definition datafile, float *data, verbose_definition verbose);
+int readPuMasubints(datafile_definition datafile, long firstsubint, long nrread, float *data, verbose_definition verbose);
 int readPSRFITSHeader(datafile_definition *datafile, int readnoscales, int nowarnings, verbose_definition verbose);
 int readFITSpulse(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose);
 int readFITSfile(datafile_definition *datafile, float *data, verbose_definition verbose);
+int readFITSsubint(datafile_definition *datafile, long subintnr, float *subintdata, verbose_definition verbose);
+int readFITSresident(datafile_definition *datafile, verbose_definition verbose);
+int internalReadHalfPSRData(datafile_definition *datafile, int halftype, verbose_definition verbose);
+void freeFITSreadcontext(datafile_definition *datafile);
 int writePSRFITSHeader(datafile_definition *datafile, verbose_definition verbose);
 int writeFITSpulse(datafile_definition datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose);
 int writeFITSfile(datafile_definition datafile, float *data, verbose_definition verbose);
@@ -42,6 +51,8 @@ int readPulseEPNData(datafile_definition *datafile, long pulsenr, int polarizati
 int writeEPNfile(datafile_definition datafile, float *data, verbose_definition verbose);
 int readEPNfile(datafile_definition *datafile, float *data, verbose_definition verbose, long request_only_one_pulse);
 int readEPNsubHeader(datafile_definition *datafile, float *scale, float *offset, verbose_definition verbose);
+int readEPNindex(datafile_definition *datafile, verbose_definition verbose);
+void freeEPNreadcontext(datafile_definition *datafile);
 int readSigprocHeader(datafile_definition *datafile, verbose_definition verbose);
 int readPulseSigprocData(datafile_definition datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose);
 int readPPOLHeader(datafile_definition *datafile, int extended, verbose_definition verbose);
@@ -53,10 +64,26 @@ int writeHistoryPSRData(datafile_definition *datafile, int argc, char **argv, in
 int writeHistoryPuma(datafile_definition datafile, verbose_definition verbose);
 int readHistoryPuma(datafile_definition *datafile, verbose_definition verbose);
 int readSigprocfile(datafile_definition datafile, float *data, verbose_definition verbose);
+int readSigprocsubints(datafile_definition datafile, long firstsubint, long nrread, float *data, verbose_definition verbose);
 int readSigprocASCIIHeader(datafile_definition *datafile, verbose_definition verbose);
 int writeSigprocASCIIHeader(datafile_definition datafile, verbose_definition verbose);
 int writeSigprocASCIIfile(datafile_definition datafile, float *data, verbose_definition verbose);
 int readSigprocASCIIfile(datafile_definition datafile, float *data, verbose_definition verbose);
+int readPSRSALSAindex(datafile_definition *datafile, verbose_definition verbose);
+void freePSRSALSAreadcontext(datafile_definition *datafile);
+int internalPSRSALSAwriteFinish(datafile_definition *datafile, verbose_definition verbose);
+static int psrsalsabinary_compression = 0;
+static long psrsalsabinary_tilesubints = 0;
+static long psrsalsabinary_tilechans = 0;
+void psrsalsabinary_set_compression(int val)
+{
+  psrsalsabinary_compression = val;
+}
+void psrsalsabinary_set_tiles(long nrsubints, long nrchans)
+{
+  psrsalsabinary_tilesubints = nrsubints;
+  psrsalsabinary_tilechans = nrchans;
+}
 int isValidPSRDATA_format(int format)
 {
   if(format == PUMA_format)
@@ -82,6 +109,20 @@ int isValidPSRDATA_format(int format)
   printerror(0, "ERROR isValidPSRDATA_format: specified data format is not recognized.");
   return 0;
 }
+int isRandomAccessPSRDATA_format(int format)
+{
+  if(format == FITS_format)
+    return 1;
+  if(format == PSRSALSA_BINARY_format)
+    return 1;
+  if(format == PUMA_format)
+    return 1;
+  if(format == SIGPROC_format)
+    return 1;
+  if(format == EPN_format)
+    return 1;
+  return 0;
+}
 void printPSRDataFormats(FILE *printdevice, int nrspaces)
 {
   int i, nrspaces2;
@@ -148,11 +189,19 @@ void cleanPSRData(datafile_definition *datafile, verbose_definition verbose)
   datafile->fptr = NULL;
   datafile->fptr_hdr = NULL;
   datafile->fits_fptr = NULL;
+  datafile->fits_readcontext = NULL;
+  datafile->epn_readcontext = NULL;
+  datafile->psrsalsa_readcontext = NULL;
+  datafile->subint_cache = NULL;
   datafile->scales = NULL;
   datafile->offsets = NULL;
   datafile->weights = NULL;
   datafile->weight_stats_set = 0;
   datafile->data = NULL;
+  datafile->data_mmap = NULL;
+  datafile->data_mmap_size = 0;
+  datafile->data_half = NULL;
+  datafile->halfType = 0;
   datafile->format = 0;
   datafile->version = 0;
   datafile->opened_flag = 0;
@@ -245,6 +294,14 @@ int copy_params_PSRData(datafile_definition datafile_source, datafile_definition
   datafile_dest->fptr = NULL;
   datafile_dest->fptr_hdr = NULL;
   datafile_dest->fits_fptr = NULL;
+  datafile_dest->fits_readcontext = NULL;
+  datafile_dest->epn_readcontext = NULL;
+  datafile_dest->psrsalsa_readcontext = NULL;
+  datafile_dest->subint_cache = NULL;
+  datafile_dest->data_half = NULL;
+  datafile_dest->halfType = 0;
+  datafile_dest->readahead_last = 0;
+  datafile_dest->readahead_next = 0;
   datafile_dest->scales = NULL;
   datafile_dest->offsets = NULL;
   datafile_dest->weights = NULL;
@@ -447,6 +504,9 @@ int writePSRSALSAHeader(datafile_definition *datafile, verbose_definition verbos
   int ret, dummyi;
   char identifier[] = "PSRSALSAdump";
   int version = 2;
+  if(psrsalsabinary_compression || psrsalsabinary_tilesubints > 0 || psrsalsabinary_tilechans > 0)
+    version = 3;
+  datafile->version = version;
   ret = fwrite(identifier, 12, 1, datafile->fptr_hdr);
   if(ret != 1) {
     fflush(stdout);
@@ -840,6 +900,8 @@ int writeHistoryPSRSALSA(datafile_definition *datafile, verbose_definition verbo
     if(curHistoryEntry->timestamp != NULL || curHistoryEntry->cmd != NULL || curHistoryEntry->user != NULL || curHistoryEntry->hostname != NULL || curHistoryEntry->nextEntry != NULL) {
       nrHistoryLines++;
       curHistoryEntry = curHistoryEntry->nextEntry;
+    }else {
+      break;
     }
   }while(curHistoryEntry != NULL);
   if(verbose.debug) {
@@ -937,6 +999,8 @@ int writeHistoryPSRSALSA(datafile_definition *datafile, verbose_definition verbo
  }
       }
       curHistoryEntry = curHistoryEntry->nextEntry;
+    }else {
+      break;
     }
   }while(curHistoryEntry != NULL);
   datafile->datastart = ftell(datafile->fptr_hdr);
@@ -946,7 +1010,7 @@ int readPSRSALSAHeader(datafile_definition *datafile, int nohistory_expected, ve
 {
   int ret, dummyi;
   char identifier[13], *txt;
-  int version, maxversion_supported = 2;
+  int version, maxversion_supported = 3;
   txt = malloc(10000);
   if(txt == NULL) {
     fflush(stdout);
@@ -979,6 +1043,7 @@ int readPSRSALSAHeader(datafile_definition *datafile, int nohistory_expected, ve
   if(verbose.debug) {
     printf("  PSRSALSA file is version %d\n", version);
   }
+  datafile->version = version;
   ret = fread(&dummyi, sizeof(int), 1, datafile->fptr_hdr);
   if(ret != 1) {
     fflush(stdout);
@@ -1587,10 +1652,297 @@ int readPSRSALSAHeader(datafile_definition *datafile, int nohistory_expected, ve
   free(txt);
   return 1;
 }
+void freePSRSALSAreadcontext(datafile_definition *datafile)
+{
+  if(datafile->psrsalsa_readcontext == NULL)
+    return;
+  free(datafile->psrsalsa_readcontext->chunkpos);
+  free(datafile->psrsalsa_readcontext->chunklen);
+  free(datafile->psrsalsa_readcontext->chunknr);
+  free(datafile->psrsalsa_readcontext->chunk);
+  free(datafile->psrsalsa_readcontext->row);
+  free(datafile->psrsalsa_readcontext->shuffled);
+  free(datafile->psrsalsa_readcontext->buffer);
+  free(datafile->psrsalsa_readcontext);
+  datafile->psrsalsa_readcontext = NULL;
+}
+long internalPSRSALSAcompress(unsigned char *src, long srcsize, unsigned char *dst, long dstsize)
+{
+  long hashtable[4096];
+  long ip, anchor, op, ref, litlen, matchlen, len, token;
+  unsigned int seq, seqref, hash;
+  for(hash = 0; hash < 4096; hash++)
+    hashtable[hash] = -1;
+  ip = 0;
+  anchor = 0;
+  op = 0;
+  while(ip + 12 <= srcsize) {
+    memcpy(&seq, &src[ip], 4);
+    hash = (seq*2654435761U) >> 20;
+    ref = hashtable[hash];
+    hashtable[hash] = ip;
+    if(ref >= 0 && ip - ref <= 65535)
+      memcpy(&seqref, &src[ref], 4);
+    if(ref < 0 || ip - ref > 65535 || seqref != seq) {
+      ip += 1 + ((ip - anchor) >> 6);
+      continue;
+    }
+    matchlen = 4;
+    while(ip + matchlen < srcsize - 5 && src[ref + matchlen] == src[ip + matchlen])
+      matchlen++;
+    litlen = ip - anchor;
+    if(op + litlen + litlen/255 + matchlen/255 + 5 > dstsize)
+      return 0;
+    token = op++;
+    if(litlen >= 15) {
+      dst[token] = 15 << 4;
+      for(len = litlen - 15; len >= 255; len -= 255)
+ dst[op++] = 255;
+      dst[op++] = len;
+    }else {
+      dst[token] = litlen << 4;
+    }
+    memcpy(&dst[op], &src[anchor], litlen);
+    op += litlen;
+    dst[op++] = (ip - ref) & 255;
+    dst[op++] = (ip - ref) >> 8;
+    if(matchlen - 4 >= 15) {
+      dst[token] |= 15;
+      for(len = matchlen - 19; len >= 255; len -= 255)
+ dst[op++] = 255;
+      dst[op++] = len;
+    }else {
+      dst[token] |= matchlen - 4;
+    }
+    ip += matchlen;
+    anchor = ip;
+  }
+  litlen = srcsize - anchor;
+  if(op + litlen + litlen/255 + 2 > dstsize)
+    return 0;
+  token = op++;
+  if(litlen >= 15) {
+    dst[token] = 15 << 4;
+    for(len = litlen - 15; len >= 255; len -= 255)
+      dst[op++] = 255;
+    dst[op++] = len;
+  }else {
+    dst[token] = litlen << 4;
+  }
+  memcpy(&dst[op], &src[anchor], litlen);
+  op += litlen;
+  return op;
+}
+int internalPSRSALSAdecompress(unsigned char *src, long srcsize, unsigned char *dst, long dstsize)
+{
+  long ip, op, litlen, matchlen, offset, i;
+  unsigned char token, b;
+  ip = 0;
+  op = 0;
+  while(ip < srcsize) {
+    token = src[ip++];
+    litlen = token >> 4;
+    if(litlen == 15) {
+      do {
+ if(ip >= srcsize)
+   return 0;
+ b = src[ip++];
+ litlen += b;
+      }while(b == 255);
+    }
+    if(ip + litlen > srcsize || op + litlen > dstsize)
+      return 0;
+    memcpy(&dst[op], &src[ip], litlen);
+    ip += litlen;
+    op += litlen;
+    if(ip == srcsize)
+      break;
+    if(ip + 2 > srcsize)
+      return 0;
+    offset = src[ip] | (src[ip+1] << 8);
+    ip += 2;
+    if(offset == 0 || offset > op)
+      return 0;
+    matchlen = token & 15;
+    if(matchlen == 15) {
+      do {
+ if(ip >= srcsize)
+   return 0;
+ b = src[ip++];
+ matchlen += b;
+      }while(b == 255);
+    }
+    matchlen += 4;
+    if(op + matchlen > dstsize)
+      return 0;
+    for(i = 0; i < matchlen; i++)
+      dst[op+i] = dst[op-offset+i];
+    op += matchlen;
+  }
+  if(op != dstsize)
+    return 0;
+  return 1;
+}
+int readPSRSALSAindex(datafile_definition *datafile, verbose_definition verbose)
+{
+  long n, tilesize, maxlen;
+  long long tiling[2];
+  psrsalsa_readcontext_definition *context;
+  freePSRSALSAreadcontext(datafile);
+  context = (psrsalsa_readcontext_definition *)calloc(1, sizeof(psrsalsa_readcontext_definition));
+  if(context == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readPSRSALSAindex: Memory allocation error");
+    return 0;
+  }
+  datafile->psrsalsa_readcontext = context;
+  fseeko(datafile->fptr, datafile->datastart, SEEK_SET);
+  if(fread(tiling, sizeof(long long), 2, datafile->fptr) != 2 || tiling[0] < 1 || tiling[0] > datafile->NrSubints || tiling[1] < 1 || tiling[1] > datafile->NrFreqChan) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readPSRSALSAindex: Reading tile size from %s failed.", datafile->filename);
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  context->tilesubints = tiling[0];
+  context->tilechans = tiling[1];
+  context->nrtilechans = (datafile->NrFreqChan+context->tilechans-1)/context->tilechans;
+  context->nrtiles = context->nrtilechans*((datafile->NrSubints+context->tilesubints-1)/context->tilesubints);
+  tilesize = context->tilesubints*context->tilechans*datafile->NrPols*datafile->NrBins;
+  context->tilesize = tilesize;
+  context->chunkpos = (long long *)malloc(context->nrtiles*sizeof(long long));
+  context->chunklen = (long long *)malloc(context->nrtiles*sizeof(long long));
+  context->chunknr = (long *)malloc(context->nrtilechans*sizeof(long));
+  context->chunk = (float *)malloc(context->nrtilechans*tilesize*sizeof(float));
+  context->shuffled = (unsigned char *)malloc(tilesize*sizeof(float));
+  if(context->chunkpos == NULL || context->chunklen == NULL || context->chunknr == NULL || context->chunk == NULL || context->shuffled == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readPSRSALSAindex: Memory allocation error");
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  for(n = 0; n < context->nrtilechans; n++)
+    context->chunknr[n] = -1;
+  if(fread(context->chunkpos, sizeof(long long), context->nrtiles, datafile->fptr) != context->nrtiles || fread(context->chunklen, sizeof(long long), context->nrtiles, datafile->fptr) != context->nrtiles) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readPSRSALSAindex: Reading chunk index from %s failed.", datafile->filename);
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  maxlen = 1;
+  for(n = 0; n < context->nrtiles; n++) {
+    if(context->chunklen[n] < 1 || context->chunklen[n] > tilesize*sizeof(float)+1 || context->chunkpos[n] < datafile->datastart) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readPSRSALSAindex: Chunk index of %s is corrupt (chunk %ld).", datafile->filename, n);
+      freePSRSALSAreadcontext(datafile);
+      return 0;
+    }
+    if(context->chunklen[n] > maxlen)
+      maxlen = context->chunklen[n];
+  }
+  context->buffer_size = maxlen;
+  context->buffer = (unsigned char *)malloc(maxlen);
+  if(context->buffer == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readPSRSALSAindex: Memory allocation error");
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  fseeko(datafile->fptr, datafile->datastart, SEEK_SET);
+  if(verbose.debug) {
+    printf("  Read chunk index of %ld tiles of %ld subints x %ld channels\n", context->nrtiles, context->tilesubints, context->tilechans);
+  }
+  return 1;
+}
+long internalPSRSALSAtileSamples(datafile_definition datafile, long tilenr, long *firstsubint, long *nrsubints, long *firstchan, long *nrchans)
+{
+  psrsalsa_readcontext_definition *context;
+  context = datafile.psrsalsa_readcontext;
+  *firstsubint = (tilenr/context->nrtilechans)*context->tilesubints;
+  *firstchan = (tilenr%context->nrtilechans)*context->tilechans;
+  *nrsubints = context->tilesubints;
+  if(*firstsubint + *nrsubints > datafile.NrSubints)
+    *nrsubints = datafile.NrSubints - *firstsubint;
+  *nrchans = context->tilechans;
+  if(*firstchan + *nrchans > datafile.NrFreqChan)
+    *nrchans = datafile.NrFreqChan - *firstchan;
+  return (*nrsubints)*(*nrchans)*datafile.NrPols*datafile.NrBins;
+}
+int internalPSRSALSAdecodeChunk(datafile_definition datafile, long chunknr, float *chunk, verbose_definition verbose)
+{
+  long i, k, nrbytes, s0, ns, f0, nf;
+  unsigned char *destbytes;
+  psrsalsa_readcontext_definition *context;
+  context = datafile.psrsalsa_readcontext;
+  nrbytes = internalPSRSALSAtileSamples(datafile, chunknr, &s0, &ns, &f0, &nf)*sizeof(float);
+  fseeko(datafile.fptr, context->chunkpos[chunknr], SEEK_SET);
+  if(fread(context->buffer, 1, context->chunklen[chunknr], datafile.fptr) != context->chunklen[chunknr]) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAdecodeChunk: File read failed.");
+    return 0;
+  }
+  if(context->buffer[0] == 0 && context->chunklen[chunknr] == nrbytes+1) {
+    memcpy(chunk, &context->buffer[1], nrbytes);
+    return 1;
+  }
+  if(context->buffer[0] != 1 || internalPSRSALSAdecompress(&context->buffer[1], context->chunklen[chunknr]-1, context->shuffled, nrbytes) == 0) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAdecodeChunk: Decompressing chunk %ld failed, the file appears to be corrupt.", chunknr);
+    return 0;
+  }
+  destbytes = (unsigned char *)chunk;
+  for(k = 0; k < sizeof(float); k++) {
+    for(i = 0; i < nrbytes/sizeof(float); i++)
+      destbytes[i*sizeof(float)+k] = context->shuffled[k*(nrbytes/sizeof(float))+i];
+  }
+  return 1;
+}
+float *readChunkPSRSALSAData(datafile_definition datafile, long chunknr, verbose_definition verbose)
+{
+  long slot;
+  float *chunk;
+  psrsalsa_readcontext_definition *context;
+  context = datafile.psrsalsa_readcontext;
+  slot = chunknr % context->nrtilechans;
+  chunk = &context->chunk[slot*context->tilesize];
+  if(context->chunknr[slot] == chunknr)
+    return chunk;
+  context->chunknr[slot] = -1;
+  if(internalPSRSALSAdecodeChunk(datafile, chunknr, chunk, verbose) == 0)
+    return NULL;
+  context->chunknr[slot] = chunknr;
+  return chunk;
+}
 int readPulsePSRSALSAData(datafile_definition datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
 {
   long long filepos;
   size_t ret;
+  if(datafile.psrsalsa_readcontext != NULL) {
+    long sample, done, run, b, p, f, s0, ns, f0, nf, chunknr;
+    float *chunk;
+    psrsalsa_readcontext_definition *context;
+    context = datafile.psrsalsa_readcontext;
+    if(context->row != NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readPulsePSRSALSAData: Cannot read from a chunked PSRSALSA binary file while it is being written.");
+      return 0;
+    }
+    sample = datafile.NrBins*(polarization+datafile.NrPols*freq)+binnr;
+    for(done = 0; done < nrSamples; done += run) {
+      b = (sample+done)%datafile.NrBins;
+      p = ((sample+done)/datafile.NrBins)%datafile.NrPols;
+      f = (sample+done)/(datafile.NrBins*datafile.NrPols);
+      chunknr = (pulsenr/context->tilesubints)*context->nrtilechans+f/context->tilechans;
+      chunk = readChunkPSRSALSAData(datafile, chunknr, verbose);
+      if(chunk == NULL)
+ return 0;
+      internalPSRSALSAtileSamples(datafile, chunknr, &s0, &ns, &f0, &nf);
+      run = datafile.NrBins-b;
+      if(run > nrSamples-done)
+ run = nrSamples-done;
+      memcpy(&pulse[done], &chunk[datafile.NrBins*(p+datafile.NrPols*(f-f0+nf*(pulsenr-s0)))+b], sizeof(float)*run);
+    }
+    return 1;
+  }
   filepos = datafile.NrBins*(polarization+datafile.NrPols*(freq+pulsenr*datafile.NrFreqChan))+binnr;
   filepos *= sizeof(float);
   filepos += datafile.datastart;
@@ -1603,15 +1955,213 @@ int readPulsePSRSALSAData(datafile_definition datafile, long pulsenr, int polari
   }
   return 1;
 }
-int writePulsePSRSALSAData(datafile_definition datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
+int internalPSRSALSAwriteStart(datafile_definition *datafile, verbose_definition verbose)
+{
+  long long tiling[2];
+  long tilesize;
+  psrsalsa_readcontext_definition *context;
+  context = (psrsalsa_readcontext_definition *)calloc(1, sizeof(psrsalsa_readcontext_definition));
+  if(context == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAwriteStart: Memory allocation error");
+    return 0;
+  }
+  datafile->psrsalsa_readcontext = context;
+  tiling[0] = 1;
+  tiling[1] = datafile->NrFreqChan;
+  if(psrsalsabinary_tilesubints > 0)
+    tiling[0] = psrsalsabinary_tilesubints;
+  if(psrsalsabinary_tilechans > 0)
+    tiling[1] = psrsalsabinary_tilechans;
+  if(tiling[0] > datafile->NrSubints)
+    tiling[0] = datafile->NrSubints;
+  if(tiling[1] > datafile->NrFreqChan)
+    tiling[1] = datafile->NrFreqChan;
+  context->tilesubints = tiling[0];
+  context->tilechans = tiling[1];
+  context->nrtilechans = (datafile->NrFreqChan+context->tilechans-1)/context->tilechans;
+  context->nrtiles = context->nrtilechans*((datafile->NrSubints+context->tilesubints-1)/context->tilesubints);
+  tilesize = context->tilesubints*context->tilechans*datafile->NrPols*datafile->NrBins;
+  context->tilesize = tilesize;
+  context->writerow = -1;
+  context->buffer_size = tilesize*sizeof(float)+1;
+  context->chunkpos = (long long *)calloc(context->nrtiles, sizeof(long long));
+  context->chunklen = (long long *)calloc(context->nrtiles, sizeof(long long));
+  context->chunk = (float *)malloc(tilesize*sizeof(float));
+  context->shuffled = (unsigned char *)malloc(tilesize*sizeof(float));
+  context->buffer = (unsigned char *)malloc(context->buffer_size);
+  if(context->chunkpos == NULL || context->chunklen == NULL || context->chunk == NULL || context->shuffled == NULL || context->buffer == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAwriteStart: Memory allocation error");
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  fseeko(datafile->fptr, datafile->datastart, SEEK_SET);
+  context->filepos = datafile->datastart + 2*(context->nrtiles+1)*sizeof(long long);
+  if(fwrite(tiling, sizeof(long long), 2, datafile->fptr) != 2) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAwriteStart: File write failed.");
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  if(fwrite(context->chunkpos, sizeof(long long), context->nrtiles, datafile->fptr) != context->nrtiles || fwrite(context->chunklen, sizeof(long long), context->nrtiles, datafile->fptr) != context->nrtiles) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAwriteStart: File write failed.");
+    freePSRSALSAreadcontext(datafile);
+    return 0;
+  }
+  return 1;
+}
+int internalPSRSALSAwriteRow(datafile_definition datafile, long row, float *rowdata, verbose_definition verbose)
+{
+  long i, k, n, p, f, nrsamples, s0, ns, f0, nf;
+  unsigned char *tilebytes;
+  psrsalsa_readcontext_definition *context;
+  context = datafile.psrsalsa_readcontext;
+  for(n = row*context->nrtilechans; n < (row+1)*context->nrtilechans; n++) {
+    nrsamples = internalPSRSALSAtileSamples(datafile, n, &s0, &ns, &f0, &nf);
+    for(p = 0; p < ns; p++) {
+      for(f = 0; f < nf; f++)
+ memcpy(&context->chunk[datafile.NrBins*datafile.NrPols*(f+nf*p)], &rowdata[datafile.NrBins*datafile.NrPols*(f0+f+datafile.NrFreqChan*p)], datafile.NrBins*datafile.NrPols*sizeof(float));
+    }
+    tilebytes = (unsigned char *)context->chunk;
+    context->chunklen[n] = 0;
+    if(psrsalsabinary_compression) {
+      for(k = 0; k < sizeof(float); k++) {
+ for(i = 0; i < nrsamples; i++)
+   context->shuffled[k*nrsamples+i] = tilebytes[i*sizeof(float)+k];
+      }
+      context->chunklen[n] = internalPSRSALSAcompress(context->shuffled, nrsamples*sizeof(float), &context->buffer[1], nrsamples*sizeof(float));
+    }
+    if(context->chunklen[n] > 0) {
+      context->buffer[0] = 1;
+    }else {
+      context->buffer[0] = 0;
+      memcpy(&context->buffer[1], tilebytes, nrsamples*sizeof(float));
+      context->chunklen[n] = nrsamples*sizeof(float);
+    }
+    context->chunklen[n] += 1;
+    context->chunkpos[n] = context->filepos;
+    fseeko(datafile.fptr, context->filepos, SEEK_SET);
+    if(fwrite(context->buffer, 1, context->chunklen[n], datafile.fptr) != context->chunklen[n]) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR internalPSRSALSAwriteRow: File write failed.");
+      return 0;
+    }
+    context->filepos += context->chunklen[n];
+  }
+  return 1;
+}
+int internalPSRSALSAwriteFinish(datafile_definition *datafile, verbose_definition verbose)
+{
+  long row, nrrows;
+  size_t ret;
+  psrsalsa_readcontext_definition *context;
+  context = datafile->psrsalsa_readcontext;
+  ret = 1;
+  if(context->row != NULL) {
+    nrrows = context->nrtiles/context->nrtilechans;
+    for(row = context->writerow; row < nrrows && ret; row++) {
+      ret = internalPSRSALSAwriteRow(*datafile, row, context->row, verbose);
+      memset(context->row, 0, context->tilesubints*datafile->NrFreqChan*datafile->NrPols*datafile->NrBins*sizeof(float));
+    }
+  }
+  if(ret) {
+    fseeko(datafile->fptr, datafile->datastart+2*sizeof(long long), SEEK_SET);
+    ret = fwrite(context->chunkpos, sizeof(long long), context->nrtiles, datafile->fptr);
+    ret += fwrite(context->chunklen, sizeof(long long), context->nrtiles, datafile->fptr);
+    if(ret != 2*context->nrtiles) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR internalPSRSALSAwriteFinish: File write failed.");
+      ret = 0;
+    }
+  }
+  if(ret && verbose.verbose) printf("  Writing is done (%ld tiles, %.1f%% of uncompressed size).\n", context->nrtiles, 100.0*(context->filepos-datafile->datastart)/(double)(datafile->NrSubints*datafile->NrFreqChan*datafile->NrPols*datafile->NrBins*sizeof(float)));
+  freePSRSALSAreadcontext(datafile);
+  if(ret == 0)
+    return 0;
+  return 1;
+}
+int internalPSRSALSAwriteBuffered(datafile_definition *datafile, verbose_definition verbose)
+{
+  long n, p, f, s0, ns, f0, nf, rowsize;
+  float *data;
+  psrsalsa_readcontext_definition *context;
+  context = datafile->psrsalsa_readcontext;
+  if(verbose.debug) {
+    printf("DEBUG: Subints of %s are not written in order, buffering the whole file until it is closed.\n", datafile->filename);
+  }
+  data = (float *)calloc(datafile->NrSubints*datafile->NrFreqChan*datafile->NrPols*datafile->NrBins, sizeof(float));
+  if(data == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalPSRSALSAwriteBuffered: Cannot allocate memory to buffer %s.", datafile->filename);
+    return 0;
+  }
+  for(n = 0; n < context->writerow*context->nrtilechans; n++) {
+    internalPSRSALSAtileSamples(*datafile, n, &s0, &ns, &f0, &nf);
+    if(internalPSRSALSAdecodeChunk(*datafile, n, context->chunk, verbose) == 0) {
+      free(data);
+      return 0;
+    }
+    for(p = 0; p < ns; p++) {
+      for(f = 0; f < nf; f++)
+ memcpy(&data[datafile->NrBins*datafile->NrPols*(f0+f+datafile->NrFreqChan*(s0+p))], &context->chunk[datafile->NrBins*datafile->NrPols*(f+nf*p)], datafile->NrBins*datafile->NrPols*sizeof(float));
+    }
+  }
+  rowsize = context->tilesubints;
+  if(rowsize > datafile->NrSubints-context->writerow*context->tilesubints)
+    rowsize = datafile->NrSubints-context->writerow*context->tilesubints;
+  memcpy(&data[datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*context->writerow*context->tilesubints], context->row, rowsize*datafile->NrFreqChan*datafile->NrPols*datafile->NrBins*sizeof(float));
+  freePSRSALSAreadcontext(datafile);
+  datafile->data = data;
+  datafile->dumpOnClose = 1;
+  return 1;
+}
+int writePulsePSRSALSAData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
 {
   long long filepos;
   size_t ret;
-  filepos = datafile.NrBins*(polarization+datafile.NrPols*(freq+pulsenr*datafile.NrFreqChan))+binnr;
+  if(datafile->version >= 3) {
+    long row;
+    psrsalsa_readcontext_definition *context;
+    if(datafile->psrsalsa_readcontext == NULL) {
+      if(internalPSRSALSAwriteStart(datafile, verbose) == 0)
+ return 0;
+      datafile->psrsalsa_readcontext->row = (float *)calloc(datafile->psrsalsa_readcontext->tilesubints*datafile->NrFreqChan*datafile->NrPols*datafile->NrBins, sizeof(float));
+      if(datafile->psrsalsa_readcontext->row == NULL) {
+ fflush(stdout);
+ printerror(verbose.debug, "ERROR writePulsePSRSALSAData: Memory allocation error");
+ freePSRSALSAreadcontext(datafile);
+ return 0;
+      }
+      datafile->psrsalsa_readcontext->writerow = 0;
+    }
+    context = datafile->psrsalsa_readcontext;
+    if(context->row == NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR writePulsePSRSALSAData: Cannot update individual subints in a chunked PSRSALSA binary file.");
+      return 0;
+    }
+    row = pulsenr/context->tilesubints;
+    if(row < context->writerow) {
+      if(internalPSRSALSAwriteBuffered(datafile, verbose) == 0)
+ return 0;
+      memcpy(&datafile->data[datafile->NrBins*(polarization+datafile->NrPols*(freq+pulsenr*datafile->NrFreqChan))+binnr], pulse, nrSamples*sizeof(float));
+      return 1;
+    }
+    for(; context->writerow < row; context->writerow++) {
+      if(internalPSRSALSAwriteRow(*datafile, context->writerow, context->row, verbose) == 0)
+ return 0;
+      memset(context->row, 0, context->tilesubints*datafile->NrFreqChan*datafile->NrPols*datafile->NrBins*sizeof(float));
+    }
+    memcpy(&context->row[datafile->NrBins*(polarization+datafile->NrPols*(freq+datafile->NrFreqChan*(pulsenr-row*context->tilesubints)))+binnr], pulse, nrSamples*sizeof(float));
+    return 1;
+  }
+  filepos = datafile->NrBins*(polarization+datafile->NrPols*(freq+pulsenr*datafile->NrFreqChan))+binnr;
   filepos *= sizeof(float);
-  filepos += datafile.datastart;
-  fseeko(datafile.fptr, filepos, SEEK_SET);
-  ret = fwrite(pulse, sizeof(float), nrSamples, datafile.fptr);
+  filepos += datafile->datastart;
+  fseeko(datafile->fptr, filepos, SEEK_SET);
+  ret = fwrite(pulse, sizeof(float), nrSamples, datafile->fptr);
   if(ret != nrSamples) {
     fflush(stdout);
     printerror(verbose.debug, "ERROR writePulsePSRSALSAData: File write failed.");
@@ -1626,6 +2176,27 @@ int readPSRSALSAfile(datafile_definition datafile, float *data, verbose_definiti
   if(verbose.verbose) {
     printf("Start reading PSRSALSA binary file\n");
   }
+  if(datafile.psrsalsa_readcontext != NULL) {
+    long s0, ns, f0, nf;
+    float *chunk;
+    for(n = 0; n < datafile.psrsalsa_readcontext->nrtiles; n++) {
+      if(verbose.verbose && verbose.nocounters == 0)
+ printf("  Progress reading PSRSALSA binary file (%.1f%%)\r", 100.0*n/(float)datafile.psrsalsa_readcontext->nrtiles);
+      chunk = readChunkPSRSALSAData(datafile, n, verbose);
+      if(chunk == NULL) {
+ fflush(stdout);
+ printerror(verbose.debug, "ERROR readPSRSALSAfile: File read failed.");
+ return 0;
+      }
+      internalPSRSALSAtileSamples(datafile, n, &s0, &ns, &f0, &nf);
+      for(p = 0; p < ns; p++) {
+ for(f = 0; f < nf; f++)
+   memcpy(&data[datafile.NrBins*datafile.NrPols*(f0+f+datafile.NrFreqChan*(s0+p))], &chunk[datafile.NrBins*datafile.NrPols*(f+nf*p)], datafile.NrBins*datafile.NrPols*sizeof(float));
+      }
+    }
+    if(verbose.verbose) printf("  Reading is done.                                \n");
+    return 1;
+  }
   fseeko(datafile.fptr, datafile.datastart, SEEK_SET);
   for(n = 0; n < datafile.NrSubints; n++) {
     for(f = 0; f < datafile.NrFreqChan; f++) {
@@ -1644,10 +2215,69 @@ int readPSRSALSAfile(datafile_definition datafile, float *data, verbose_definiti
   if(verbose.verbose) printf("  Reading is done.                                \n");
   return 1;
 }
+int mapPSRSALSAfile(datafile_definition *datafile, verbose_definition verbose)
+{
+  int i;
+  long long datasize, offset;
+  long pagesize;
+  struct stat filestat;
+  void *ptr;
+  if(datafile->psrsalsa_readcontext != NULL)
+    return 0;
+  datasize = datafile->NrSubints*datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float);
+  if(datasize <= 0)
+    return 0;
+  if(datafile->datastart % sizeof(float) != 0) {
+    if(verbose.debug) {
+      printf("  Data in %s is not aligned in the file, it will not be memory mapped.\n", datafile->filename);
+    }
+    return 0;
+  }
+  if(fstat(fileno(datafile->fptr), &filestat) != 0) {
+    return 0;
+  }
+  if(filestat.st_size < datafile->datastart + datasize) {
+    return 0;
+  }
+  pagesize = sysconf(_SC_PAGESIZE);
+  offset = datafile->datastart - datafile->datastart % pagesize;
+  ptr = mmap(NULL, datasize + datafile->datastart - offset, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(datafile->fptr), offset);
+  if(ptr == MAP_FAILED) {
+    if(verbose.debug) {
+      printf("  Memory mapping %s failed (%s), the data will be read instead.\n", datafile->filename, strerror(errno));
+    }
+    return 0;
+  }
+  datafile->data_mmap = ptr;
+  datafile->data_mmap_size = datasize + datafile->datastart - offset;
+  datafile->data = (float *)((char *)ptr + datafile->datastart - offset);
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("Memory mapped PSRSALSA binary file (%.3fGB)\n", datasize/1073741824.0);
+  }
+  return 1;
+}
 int writePSRSALSAfile(datafile_definition datafile, float *data, verbose_definition verbose)
 {
   long n, f, p;
   size_t ret;
+  if(datafile.version >= 3) {
+    long nrrows;
+    datafile.psrsalsa_readcontext = NULL;
+    if(internalPSRSALSAwriteStart(&datafile, verbose) == 0)
+      return 0;
+    nrrows = datafile.psrsalsa_readcontext->nrtiles/datafile.psrsalsa_readcontext->nrtilechans;
+    for(n = 0; n < nrrows; n++) {
+      if(verbose.verbose && verbose.nocounters == 0)
+ printf("  Progress writing PSRSALSA binary file (%.1f%%)\r", 100.0*n/(float)nrrows);
+      if(internalPSRSALSAwriteRow(datafile, n, &data[datafile.NrBins*datafile.NrPols*datafile.NrFreqChan*n*datafile.psrsalsa_readcontext->tilesubints], verbose) == 0) {
+ freePSRSALSAreadcontext(&datafile);
+ return 0;
+      }
+    }
+    return internalPSRSALSAwriteFinish(&datafile, verbose);
+  }
   fseeko(datafile.fptr, datafile.datastart, SEEK_SET);
   for(n = 0; n < datafile.NrSubints; n++) {
     for(f = 0; f < datafile.NrFreqChan; f++) {
@@ -2210,7 +2840,31 @@ int openPSRData(datafile_definition *datafile, char *filename, int format, int e
   }
   if(read_in_memory && datafile->opened_flag) {
     if(readHeaderPSRData(datafile, 0, nowarnings, verbose2)) {
-      if(datafile->NrPols != 0) {
+      int mapped = 0;
+      if((read_in_memory == 4 || read_in_memory == 5) && isRandomAccessPSRDATA_format(datafile->format)) {
+ if(internalReadHalfPSRData(datafile, read_in_memory == 4 ? HALFTYPE_BFLOAT16 : HALFTYPE_FLOAT16, verbose2) == 0) {
+   fflush(stdout);
+   printerror(verbose.debug, "ERROR openPSRData: Cannot read data.");
+   closePSRData(datafile, 0, verbose2);
+   return 0;
+ }
+ datafile->deferredRead = 1;
+ return datafile->opened_flag;
+      }
+      if(read_in_memory == 3 && datafile->format == FITS_format) {
+ if(readFITSresident(datafile, verbose2)) {
+   datafile->deferredRead = 1;
+   return datafile->opened_flag;
+ }
+      }
+      if(datafile->format == PSRSALSA_BINARY_format && enable_write == 0) {
+ mapped = mapPSRSALSAfile(datafile, verbose2);
+      }
+      if(mapped == 0 && (read_in_memory == 2 || read_in_memory == 3) && isRandomAccessPSRDATA_format(datafile->format)) {
+ datafile->deferredRead = 1;
+ return datafile->opened_flag;
+      }
+      if(mapped == 0 && datafile->NrPols != 0) {
  long datasize = datafile->NrSubints*datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float);
  datafile->data = (float *)malloc(datasize);
  if(datafile->data == NULL) {
@@ -2220,7 +2874,7 @@ int openPSRData(datafile_definition *datafile, char *filename, int format, int e
    return 0;
  }
       }
-      if(readPSRData(datafile, datafile->data, verbose2)) {
+      if(mapped || readPSRData(datafile, datafile->data, verbose2)) {
  closePSRData(datafile, 2, verbose2);
  datafile->format = MEMORY_format;
  datafile->opened_flag = 1;
@@ -2246,6 +2900,8 @@ int closePSRData(datafile_definition *datafile, int perserve_info, verbose_defin
   if(verbose.debug) {
     printf("Closing file '%s'\n", datafile->filename);
   }
+  if(datafile->subint_cache != NULL)
+    freeSubintCachePSRData(datafile, verbose);
   if(datafile->opened_flag) {
     if(datafile->dumpOnClose) {
       if(verbose.debug) {
@@ -2279,6 +2935,7 @@ int closePSRData(datafile_definition *datafile, int perserve_info, verbose_defin
       if(verbose.debug) {
  printf("  - Releasing memory related to scales/offsets/weights\n");
       }
+      freeFITSreadcontext(datafile);
       free(datafile->scales);
       free(datafile->offsets);
       free(datafile->weights);
@@ -2288,18 +2945,28 @@ int closePSRData(datafile_definition *datafile, int perserve_info, verbose_defin
     }else if(datafile->format != MEMORY_format){
       if(verbose.debug) {
  printf("  - Releasing file pointer\n");
+      }
+      if(datafile->format == EPN_format)
+ freeEPNreadcontext(datafile);
+      if(datafile->format == PSRSALSA_BINARY_format) {
+ if(datafile->psrsalsa_readcontext != NULL && datafile->psrsalsa_readcontext->row != NULL) {
+   if(internalPSRSALSAwriteFinish(datafile, verbose) == 0) {
+     fflush(stdout);
+     printerror(verbose.debug, "ERROR closePSRData: Writing the last subints of %s failed.", datafile->filename);
+   }
+ }
+ freePSRSALSAreadcontext(datafile);
       }
       fclose(datafile->fptr);
     }
     datafile->opened_flag = 0;
   }
   if(perserve_info != 2) {
-    if(datafile->data != NULL) {
+    if(datafile->data != NULL || datafile->data_half != NULL) {
       if(verbose.debug) {
  printf("  - Releasing memory containing data\n");
       }
-      free(datafile->data);
-      datafile->data = NULL;
+      free_data_PSRData(datafile, verbose);
     }
   }
   if(perserve_info == 0) {
@@ -2371,6 +3038,67 @@ int closePSRData(datafile_definition *datafile, int perserve_info, verbose_defin
   }
   return status;
 }
+void free_data_PSRData(datafile_definition *datafile, verbose_definition verbose)
+{
+  if(datafile->data_mmap != NULL) {
+    if(munmap(datafile->data_mmap, datafile->data_mmap_size) != 0) {
+      printwarning(verbose.debug, "WARNING free_data_PSRData: Releasing memory mapped data failed: %s", strerror(errno));
+    }
+    datafile->data_mmap = NULL;
+    datafile->data_mmap_size = 0;
+  }else if(datafile->data != NULL) {
+    free(datafile->data);
+  }
+  datafile->data = NULL;
+  if(datafile->data_half != NULL) {
+    free(datafile->data_half);
+    datafile->data_half = NULL;
+  }
+}
+int internalReadHalfPSRData(datafile_definition *datafile, int halftype, verbose_definition verbose)
+{
+  long n, i, subintsize;
+  float *subint, maxvalue;
+  unsigned short *data_half;
+  subintsize = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan;
+  data_half = (unsigned short *)malloc(datafile->NrSubints*subintsize*sizeof(unsigned short));
+  subint = (float *)malloc(subintsize*sizeof(float));
+  if(data_half == NULL || subint == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalReadHalfPSRData: Cannot allocate memory (data=%.3fGB).", datafile->NrSubints*subintsize*sizeof(unsigned short)/1073741824.0);
+    free(data_half);
+    free(subint);
+    return 0;
+  }
+  if(verbose.verbose) {
+    printf("Keeping data of %s in memory with %s precision\n", datafile->filename, halftype == HALFTYPE_BFLOAT16 ? "bfloat16" : "float16");
+  }
+  maxvalue = 0;
+  for(n = 0; n < datafile->NrSubints; n++) {
+    if(readSubintPSRData(datafile, n, subint, verbose) == 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR internalReadHalfPSRData: Cannot read subint %ld.", n);
+      free(data_half);
+      free(subint);
+      return 0;
+    }
+    if(halftype == HALFTYPE_FLOAT16) {
+      for(i = 0; i < subintsize; i++) {
+ if(fabs(subint[i]) > maxvalue)
+   maxvalue = fabs(subint[i]);
+      }
+    }
+    convertFloatToHalf(subint, &data_half[n*subintsize], subintsize, halftype);
+  }
+  free(subint);
+  if(maxvalue > 65504.0) {
+    fflush(stdout);
+    printwarning(verbose.debug, "WARNING internalReadHalfPSRData: Data of %s exceeds the float16 range (maximum absolute value %e). Consider bfloat16 storage or rescaling the data.", datafile->filename, maxvalue);
+  }
+  datafile->data_half = data_half;
+  datafile->halfType = halftype;
+  return 1;
+}
 static char * internal_gentype_string_undefined = "Not set";
 static char * internal_gentype_string_profile = "Profile";
 static char * internal_gentype_string_pulsestack = "Pulsestack";
@@ -3057,6 +3785,12 @@ int readHeaderPSRData(datafile_definition *datafile, int readnoscales, int nowar
   }
   copyVerboseState(verbose, &verbose2);
   verbose2.indent = verbose.indent + 2;
+  if(readnoscales && datafile->enable_write_flag == 0 && readHeaderCachePSRData(datafile, verbose)) {
+    if(verbose.verbose) {
+      printHeaderPSRData(*datafile, 0, verbose2);
+    }
+    return 1;
+  }
   if(datafile->format == PSRSALSA_BINARY_format) {
     if(verbose.verbose) {
       for(i = 0; i < verbose.indent; i++)
@@ -3064,6 +3798,8 @@ int readHeaderPSRData(datafile_definition *datafile, int readnoscales, int nowar
       printf("Reading PSRSALSA binary header\n");
     }
     ret = readPSRSALSAHeader(datafile, 0, verbose);
+    if(ret == 1 && datafile->version >= 3)
+      ret = readPSRSALSAindex(datafile, verbose);
   }else if(datafile->format == PUMA_format) {
     if(verbose.verbose) {
       for(i = 0; i < verbose.indent; i++)
@@ -3090,6 +3826,8 @@ int readHeaderPSRData(datafile_definition *datafile, int readnoscales, int nowar
       ret = 0;
       ret = readEPNsubHeader(datafile, &scale, &offset, verbose);
     }
+    if(ret == 1)
+      ret = readEPNindex(datafile, verbose);
   }else if(datafile->format == FITS_format) {
     if(verbose.verbose) {
       for(i = 0; i < verbose.indent; i++)
@@ -3304,6 +4042,9 @@ int readHeaderPSRData(datafile_definition *datafile, int readnoscales, int nowar
   if(readHistoryPSRData(datafile, verbose2) == 0) {
     printwarning(verbose.debug, "WARNING: Reading history failed.");
   }
+  if(readnoscales && datafile->enable_write_flag == 0) {
+    writeHeaderCachePSRData(datafile, verbose);
+  }
   if(verbose.verbose) {
     printHeaderPSRData(*datafile, 0, verbose2);
   }
@@ -3396,9 +4137,196 @@ int writeHeaderPSRData(datafile_definition *datafile, int argc, char **argv, int
   }
   return ret;
 }
+int readaheadPSRData(datafile_definition *datafile, long firstsubint, long nrsubints, verbose_definition verbose)
+{
+#ifdef POSIX_FADV_WILLNEED
+  long long start, length;
+  long p, f;
+  int fd;
+  if(datafile->format == MEMORY_format || datafile->fptr == NULL || datafile->data_half != NULL)
+    return 1;
+  if(firstsubint < 0) {
+    nrsubints += firstsubint;
+    firstsubint = 0;
+  }
+  if(firstsubint+nrsubints > datafile->NrSubints)
+    nrsubints = datafile->NrSubints-firstsubint;
+  if(nrsubints <= 0)
+    return 1;
+  fd = fileno(datafile->fptr);
+  if(datafile->format == PSRSALSA_BINARY_format && datafile->psrsalsa_readcontext != NULL) {
+    p = (firstsubint/datafile->psrsalsa_readcontext->tilesubints)*datafile->psrsalsa_readcontext->nrtilechans;
+    f = ((firstsubint+nrsubints-1)/datafile->psrsalsa_readcontext->tilesubints+1)*datafile->psrsalsa_readcontext->nrtilechans-1;
+    start = datafile->psrsalsa_readcontext->chunkpos[p];
+    length = datafile->psrsalsa_readcontext->chunkpos[f]+datafile->psrsalsa_readcontext->chunklen[f]-start;
+    if(length > 0)
+      posix_fadvise(fd, start, length, POSIX_FADV_WILLNEED);
+  }else if(datafile->format == PSRSALSA_BINARY_format) {
+    length = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float);
+    start = datafile->datastart + firstsubint*length;
+    posix_fadvise(fd, start, nrsubints*length, POSIX_FADV_WILLNEED);
+  }else if(datafile->format == PUMA_format) {
+    length = datafile->NrBins*sizeof(float);
+    for(p = 0; p < datafile->NrPols; p++) {
+      for(f = 0; f < datafile->NrFreqChan; f++) {
+ start = datafile->datastart + ((p*datafile->NrFreqChan+f)*datafile->NrSubints+firstsubint)*length;
+ posix_fadvise(fd, start, nrsubints*length, POSIX_FADV_WILLNEED);
+      }
+    }
+  }else if(datafile->format == EPN_format && datafile->epn_readcontext != NULL) {
+    length = datafile->epn_readcontext->buffer_size;
+    posix_fadvise(fd, firstsubint*length, nrsubints*length, POSIX_FADV_WILLNEED);
+  }else if(datafile->format == SIGPROC_format) {
+    length = datafile->NrBins*datafile->NrFreqChan*datafile->NrBits/8 + datafile->datastart;
+    start = datafile->datastart + firstsubint*length;
+    posix_fadvise(fd, start, nrsubints*length, POSIX_FADV_WILLNEED);
+  }
+#endif
+  return 1;
+}
+int enableSubintCachePSRData(datafile_definition *datafile, long maxbytes, verbose_definition verbose)
+{
+  long i, subintsize;
+  subint_cache_definition *cache;
+  if(datafile->subint_cache != NULL)
+    freeSubintCachePSRData(datafile, verbose);
+  if(datafile->format == MEMORY_format)
+    return 1;
+  subintsize = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan;
+  if(subintsize <= 0) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR enableSubintCachePSRData: Header of %s is not read in.", datafile->filename);
+    return 0;
+  }
+  cache = (subint_cache_definition *)calloc(1, sizeof(subint_cache_definition));
+  if(cache == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR enableSubintCachePSRData: Memory allocation error.");
+    return 0;
+  }
+  cache->nrslots = maxbytes/(subintsize*sizeof(float));
+  if(cache->nrslots > datafile->NrSubints)
+    cache->nrslots = datafile->NrSubints;
+  if(cache->nrslots < 1)
+    cache->nrslots = 1;
+  cache->nrsubints = datafile->NrSubints;
+  cache->subintnr = (long *)malloc(cache->nrslots*sizeof(long));
+  cache->slotnr = (long *)malloc(cache->nrsubints*sizeof(long));
+  cache->lastuse = (unsigned long *)malloc(cache->nrslots*sizeof(unsigned long));
+  cache->data = (float *)malloc(cache->nrslots*subintsize*sizeof(float));
+  if(cache->subintnr == NULL || cache->slotnr == NULL || cache->lastuse == NULL || cache->data == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR enableSubintCachePSRData: Cannot allocate memory for %ld cached subints.", cache->nrslots);
+    free(cache->subintnr);
+    free(cache->slotnr);
+    free(cache->lastuse);
+    free(cache->data);
+    free(cache);
+    return 0;
+  }
+  for(i = 0; i < cache->nrslots; i++) {
+    cache->subintnr[i] = -1;
+    cache->lastuse[i] = 0;
+  }
+  for(i = 0; i < cache->nrsubints; i++)
+    cache->slotnr[i] = -1;
+  datafile->subint_cache = cache;
+  if(verbose.debug) {
+    printf("Caching up to %ld subints of %s\n", cache->nrslots, datafile->filename);
+  }
+  return 1;
+}
+void freeSubintCachePSRData(datafile_definition *datafile, verbose_definition verbose)
+{
+  if(datafile->subint_cache == NULL)
+    return;
+  if(verbose.debug) {
+    printf("  - Releasing subint cache (%ld hits, %ld misses)\n", datafile->subint_cache->hits, datafile->subint_cache->misses);
+  }
+  free(datafile->subint_cache->subintnr);
+  free(datafile->subint_cache->slotnr);
+  free(datafile->subint_cache->lastuse);
+  free(datafile->subint_cache->data);
+  free(datafile->subint_cache);
+  datafile->subint_cache = NULL;
+}
+float *internalSubintCachePSRData(datafile_definition *datafile, long subintnr, verbose_definition verbose)
+{
+  long i, slot, subintsize;
+  int ret;
+  subint_cache_definition *cache;
+  cache = datafile->subint_cache;
+  subintsize = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan;
+  cache->clock++;
+  if(subintnr < 0 || subintnr >= cache->nrsubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalSubintCachePSRData: Subint %ld is not in the cached range.", subintnr);
+    return NULL;
+  }
+  slot = cache->slotnr[subintnr];
+  if(slot >= 0) {
+    cache->hits++;
+    cache->lastuse[slot] = cache->clock;
+    return &(cache->data[slot*subintsize]);
+  }
+  slot = 0;
+  for(i = 1; i < cache->nrslots; i++) {
+    if(cache->lastuse[i] < cache->lastuse[slot])
+      slot = i;
+  }
+  if(cache->subintnr[slot] >= 0)
+    cache->slotnr[cache->subintnr[slot]] = -1;
+  cache->misses++;
+  datafile->subint_cache = NULL;
+  ret = readSubintPSRData(datafile, subintnr, &(cache->data[slot*subintsize]), verbose);
+  datafile->subint_cache = cache;
+  if(ret == 0) {
+    cache->subintnr[slot] = -1;
+    cache->lastuse[slot] = 0;
+    return NULL;
+  }
+  cache->subintnr[slot] = subintnr;
+  cache->slotnr[subintnr] = slot;
+  cache->lastuse[slot] = cache->clock;
+  return &(cache->data[slot*subintsize]);
+}
+void internalReadaheadPSRData(datafile_definition *datafile, long subintnr, verbose_definition verbose)
+{
+  if(datafile->format != PSRSALSA_BINARY_format && datafile->format != PUMA_format && datafile->format != EPN_format)
+    return;
+  if(subintnr != datafile->readahead_last && subintnr != datafile->readahead_last+1) {
+    datafile->readahead_last = subintnr;
+    datafile->readahead_next = subintnr+1;
+    return;
+  }
+  datafile->readahead_last = subintnr;
+  if(subintnr+ReadAheadSubints/2 >= datafile->readahead_next) {
+    if(datafile->readahead_next < subintnr)
+      datafile->readahead_next = subintnr;
+    readaheadPSRData(datafile, datafile->readahead_next, subintnr+ReadAheadSubints-datafile->readahead_next, verbose);
+    datafile->readahead_next = subintnr+ReadAheadSubints;
+  }
+}
 int readPulsePSRData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
 {
-  if(datafile->format == PSRSALSA_BINARY_format)
+  if(datafile->subint_cache != NULL) {
+    float *cached;
+    if(pulsenr < 0 || pulsenr >= datafile->NrSubints) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readPulsePSRData: Subint %ld does not exist.", pulsenr);
+      return 0;
+    }
+    cached = internalSubintCachePSRData(datafile, pulsenr, verbose);
+    if(cached == NULL)
+      return 0;
+    memcpy(pulse, &cached[datafile->NrBins*(polarization+datafile->NrPols*freq)+binnr], sizeof(float)*nrSamples);
+    return 1;
+  }
+  internalReadaheadPSRData(datafile, pulsenr, verbose);
+  if(datafile->data_half != NULL) {
+    convertHalfToFloat(&datafile->data_half[datafile->NrBins*(polarization+datafile->NrPols*(freq+pulsenr*datafile->NrFreqChan))+binnr], pulse, nrSamples, datafile->halfType);
+    return 1;
+  }else if(datafile->format == PSRSALSA_BINARY_format)
     return readPulsePSRSALSAData(*datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse, verbose);
   else if(datafile->format == PUMA_format)
     return readPulseWSRTData(*datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse);
@@ -3419,6 +4347,106 @@ int readPulsePSRData(datafile_definition *datafile, long pulsenr, int polarizati
   }
   return 0;
 }
+int readSubintPSRData(datafile_definition *datafile, long subintnr, float *subint, verbose_definition verbose)
+{
+  long f, p;
+  if(subintnr < 0 || subintnr >= datafile->NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readSubintPSRData: Subint %ld does not exist.", subintnr);
+    return 0;
+  }
+  if(datafile->subint_cache != NULL) {
+    float *cached;
+    cached = internalSubintCachePSRData(datafile, subintnr, verbose);
+    if(cached == NULL)
+      return 0;
+    memcpy(subint, cached, datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float));
+    return 1;
+  }
+  internalReadaheadPSRData(datafile, subintnr, verbose);
+  if(datafile->data_half != NULL) {
+    convertHalfToFloat(&datafile->data_half[datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*subintnr], subint, datafile->NrBins*datafile->NrPols*datafile->NrFreqChan, datafile->halfType);
+    return 1;
+  }else if(datafile->format == FITS_format) {
+    return readFITSsubint(datafile, subintnr, subint, verbose);
+  }else if(datafile->format == PSRSALSA_BINARY_format) {
+    return readPulsePSRSALSAData(*datafile, subintnr, 0, 0, 0, datafile->NrBins*datafile->NrPols*datafile->NrFreqChan, subint, verbose);
+  }else if(datafile->format == MEMORY_format) {
+    memcpy(subint, &datafile->data[datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*subintnr], datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float));
+    return 1;
+  }
+  for(f = 0; f < datafile->NrFreqChan; f++) {
+    for(p = 0; p < datafile->NrPols; p++) {
+      if(readPulsePSRData(datafile, subintnr, p, f, 0, datafile->NrBins, &subint[datafile->NrBins*(p+datafile->NrPols*f)], verbose) == 0) {
+ fflush(stdout);
+ printerror(verbose.debug, "ERROR readSubintPSRData: Reading subint %ld failed.", subintnr);
+ return 0;
+      }
+    }
+  }
+  return 1;
+}
+int readSubintsPSRData(datafile_definition *datafile, long firstsubint, long nrsubints, float *data, verbose_definition verbose)
+{
+  long n, subintsize;
+  if(firstsubint < 0 || nrsubints < 0 || firstsubint+nrsubints > datafile->NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readSubintsPSRData: Subints %ld-%ld do not exist.", firstsubint, firstsubint+nrsubints-1);
+    return 0;
+  }
+  if(datafile->subint_cache == NULL && datafile->data_half == NULL) {
+    if(datafile->format == PUMA_format)
+      return readPuMasubints(*datafile, firstsubint, nrsubints, data, verbose);
+    else if(datafile->format == SIGPROC_format)
+      return readSigprocsubints(*datafile, firstsubint, nrsubints, data, verbose);
+    else if(firstsubint == 0 && nrsubints == datafile->NrSubints && datafile->format != MEMORY_format)
+      return readPSRData(datafile, data, verbose);
+  }
+  subintsize = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan;
+  for(n = 0; n < nrsubints; n++) {
+    if(verbose.verbose && verbose.nocounters == 0) {
+      printf("  %.1f%%     \r", 100.0*n/(float)nrsubints);
+      fflush(stdout);
+    }
+    if(readSubintPSRData(datafile, firstsubint+n, &data[subintsize*n], verbose) == 0)
+      return 0;
+  }
+  return 1;
+}
+int internalLoadDeferredPSRData(datafile_definition *datafile, verbose_definition verbose)
+{
+  long datasize;
+  float *data;
+  datasize = datafile->NrSubints*datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float);
+  data = (float *)malloc(datasize);
+  if(data == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalLoadDeferredPSRData: Cannot allocate memory (data=%ld bytes=%.3fGB).", datasize, datasize/1073741824.0);
+    return 0;
+  }
+  if(readSubintsPSRData(datafile, 0, datafile->NrSubints, data, verbose) == 0) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalLoadDeferredPSRData: Cannot read data.");
+    free(data);
+    return 0;
+  }
+  closePSRData(datafile, 1, verbose);
+  datafile->data = data;
+  datafile->format = MEMORY_format;
+  datafile->opened_flag = 1;
+  datafile->deferredRead = 0;
+  return 1;
+}
+int get_pointer_PulsePSRData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, float **pulse_ptr, verbose_definition verbose)
+{
+  if(datafile->format != MEMORY_format || datafile->data == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR get_pointer_PulsePSRData: Only works if data is loaded into memory.");
+    return 0;
+  }
+  *pulse_ptr = &datafile->data[datafile->NrBins*(polarization+datafile->NrPols*(freq+pulsenr*datafile->NrFreqChan))+binnr];
+  return 1;
+}
 int writePulsePSRData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
 {
   if(pulsenr < 0 || binnr < 0 || freq < 0) {
@@ -3426,6 +4454,15 @@ int writePulsePSRData(datafile_definition *datafile, long pulsenr, int polarizat
     printerror(verbose.debug, "ERROR writePulsePSRData: Parameters outside boundaries.");
     return 0;
   }
+  if(datafile->subint_cache != NULL && pulsenr < datafile->subint_cache->nrsubints) {
+    long slot;
+    slot = datafile->subint_cache->slotnr[pulsenr];
+    if(slot >= 0) {
+      datafile->subint_cache->subintnr[slot] = -1;
+      datafile->subint_cache->lastuse[slot] = 0;
+      datafile->subint_cache->slotnr[pulsenr] = -1;
+    }
+  }
   if(datafile->format == MEMORY_format || datafile->dumpOnClose) {
     if(datafile->dumpOnClose && datafile->data == NULL) {
       long datasize = datafile->NrSubints*datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*sizeof(float);
@@ -3447,7 +4484,7 @@ int writePulsePSRData(datafile_definition *datafile, long pulsenr, int polarizat
     }
     memcpy(&datafile->data[datafile->NrBins*(polarization+datafile->NrPols*(freq+pulsenr*datafile->NrFreqChan))+binnr], pulse, sizeof(float)*nrSamples);
   }else if(datafile->format == PSRSALSA_BINARY_format) {
-    return writePulsePSRSALSAData(*datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse, verbose);
+    return writePulsePSRSALSAData(datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse, verbose);
   }else if(datafile->format == PUMA_format) {
     return writePulseWSRTData(*datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse);
   }else if(datafile->format == FITS_format) {
@@ -3633,16 +4670,39 @@ int read_rmsPSRData(datafile_definition datafile, float *rms, float *avrg, int *
   free(avrg_double);
   return 1;
 }
+int internalHeaderKeyChangesLayout(char *identifier)
+{
+  if(strcasecmp(identifier,"nrpulses") == 0 || strcasecmp(identifier,"npulses") == 0 || strcasecmp(identifier,"pulses") == 0 || strcasecmp(identifier,"nrsub") == 0 || strcasecmp(identifier,"nsub") == 0 || strcasecmp(identifier, "nsubint") == 0 || strcasecmp(identifier, "subints") == 0)
+    return 1;
+  if(strcasecmp(identifier,"nrbin") == 0 || strcasecmp(identifier,"nbin") == 0)
+    return 1;
+  if(strcasecmp(identifier,"nrbits") == 0 || strcasecmp(identifier,"nbits") == 0)
+    return 1;
+  if(strcasecmp(identifier,"nrchan") == 0 || strcasecmp(identifier,"nchan") == 0 || strcasecmp(identifier,"nrfreq") == 0 || strcasecmp(identifier,"nfreq") == 0 || strcasecmp(identifier,"nrfreqchan") == 0 || strcasecmp(identifier,"nfreqchan") == 0)
+    return 1;
+  if(strcasecmp(identifier,"nrpol") == 0 || strcasecmp(identifier,"npol") == 0 || strcasecmp(identifier,"nrpols") == 0 || strcasecmp(identifier,"npols") == 0)
+    return 1;
+  return 0;
+}
 int PSRDataHeader_parse_commandline(datafile_definition *psrdata, int argc, char **argv, verbose_definition verbose)
 {
-  int i, j, ok;
+  int i, j, ok, relayout;
   char identifier[100], value[100], txt[100];
   ok = 0;
+  relayout = 0;
   for(i = 1; i < argc - 1; i++) {
     if(strcmp(argv[i], "-header") == 0 || strcmp(argv[i], "-headerUFL") == 0) {
       ok = 1;
+      if(strcmp(argv[i], "-header") == 0 && sscanf(argv[i+1], "%99s", identifier) == 1) {
+ if(internalHeaderKeyChangesLayout(identifier))
+   relayout = 1;
+      }
     }
   }
+  if(relayout && psrdata->deferredRead) {
+    if(internalLoadDeferredPSRData(psrdata, verbose) == 0)
+      return 0;
+  }
   if(ok && verbose.verbose) {
     printf("Changing header parameters:\n");
   }
@@ -16,7 +16,10 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #define _FILE_OFFSET_BITS 64
 #define _USE_LARGEFILE 1
 #define _LARGEFILE_SOURCE 1
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <math.h>
 #include "psrsalsa.h"
 void stripspaces(char *txt)
@@ -893,54 +896,149 @@ int writeEPNfile(datafile_definition datafile, float *data, verbose_definition v
   printf("  Done                       \n");
   return 1;
 }
-int readPulseEPNData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
+void freeEPNreadcontext(datafile_definition *datafile)
+{
+  if(datafile->epn_readcontext == NULL)
+    return;
+  free(datafile->epn_readcontext->recordpos);
+  free(datafile->epn_readcontext->scale);
+  free(datafile->epn_readcontext->offset);
+  free(datafile->epn_readcontext->buffer);
+  free(datafile->epn_readcontext);
+  datafile->epn_readcontext = NULL;
+}
+int internalEPNparseScales(char *subheader, float *scale, float *offset)
 {
-  float scale, offset;
-  int n;
-  long pos, ret, nrrecords;
-  nrrecords = datafile->NrBins/20;
-  if(datafile->NrBins > nrrecords*20)
-    nrrecords += 1;
+  char txt[13];
+  memcpy(txt, subheader+80, 12);
+  txt[12] = 0;
+  if(sscanf(txt, "%f", scale) != 1)
+    return 0;
+  memcpy(txt, subheader+92, 12);
+  txt[12] = 0;
+  if(sscanf(txt, "%f", offset) != 1)
+    return 0;
+  return 1;
+}
+int internalEPNdecodeHex(char *txt, long nrSamples, float scale, float offset, float *pulse)
+{
+  long n;
+  int i, bad;
+  unsigned int c, iprofile;
+  bad = 0;
+  for(n = 0; n < nrSamples; n++) {
+    iprofile = 0;
+    for(i = 0; i < 4; i++) {
+      c = (unsigned char)txt[4*n+i];
+      bad |= !isxdigit(c);
+      iprofile = (iprofile << 4) | ((c & 15) + 9*(c >> 6));
+    }
+    pulse[n] = (float)iprofile / scale + offset;
+  }
+  if(bad)
+    return 0;
+  return 1;
+}
+int readEPNindex(datafile_definition *datafile, verbose_definition verbose)
+{
+  long n, p, record, recordsize;
+  char subheader[104];
+  epn_readcontext_definition *context;
+  freeEPNreadcontext(datafile);
   if(datafile->NrFreqChan > 1) {
-    printerror(verbose.debug, "ERROR readPulseEPNData: Only one freq channel is supported in this data format");
+    printerror(verbose.debug, "ERROR readEPNindex: Only one freq channel is supported in this data format");
     return 0;
   }
-  pos = 480+(160+nrrecords*80)*(datafile->NrPols*datafile->NrFreqChan);
-  pos *= pulsenr;
-  pos += 480;
-  pos += (160+nrrecords*80)*polarization;
-  fseek(datafile->fptr, pos, SEEK_SET);
-  if(readEPNsubHeader(datafile, &scale, &offset, verbose) == 0) {
-    printerror(verbose.debug, "ERROR readPulseEPNData: Reading subheader failed.");
+  context = (epn_readcontext_definition *)calloc(1, sizeof(epn_readcontext_definition));
+  if(context == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readEPNindex: Memory allocation error");
     return 0;
   }
-  fseek(datafile->fptr, 4*binnr, SEEK_CUR);
-  unsigned int iprofile;
-  for(n = 0; n < nrSamples; n++) {
-    ret = fscanf(datafile->fptr,"%04X", &iprofile);
-    if(ret != 1) {
-      printerror(verbose.debug, "ERROR readPulseEPNData: Reading data failed.");
+  datafile->epn_readcontext = context;
+  context->nrlines = datafile->NrBins/20;
+  if(datafile->NrBins > context->nrlines*20)
+    context->nrlines += 1;
+  recordsize = 160+context->nrlines*80;
+  context->recordpos = (long *)malloc(datafile->NrSubints*datafile->NrPols*sizeof(long));
+  context->scale = (float *)malloc(datafile->NrSubints*datafile->NrPols*sizeof(float));
+  context->offset = (float *)malloc(datafile->NrSubints*datafile->NrPols*sizeof(float));
+  context->buffer_size = 480+recordsize*datafile->NrPols;
+  context->buffer = (char *)malloc(context->buffer_size);
+  if(context->recordpos == NULL || context->scale == NULL || context->offset == NULL || context->buffer == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readEPNindex: Memory allocation error");
+    freeEPNreadcontext(datafile);
+    return 0;
+  }
+  for(n = 0; n < datafile->NrSubints; n++) {
+    for(p = 0; p < datafile->NrPols; p++) {
+      record = n*datafile->NrPols+p;
+      context->recordpos[record] = n*context->buffer_size + 480 + p*recordsize;
+      fseek(datafile->fptr, context->recordpos[record], SEEK_SET);
+      if(fread(subheader, 1, 104, datafile->fptr) != 104 || internalEPNparseScales(subheader, &(context->scale[record]), &(context->offset[record])) == 0) {
+ printerror(verbose.debug, "ERROR readEPNindex: Reading subheader of subint %ld, polarization %ld failed.", n, p);
+ freeEPNreadcontext(datafile);
+ return 0;
+      }
+    }
+  }
+  return 1;
+}
+int readPulseEPNData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
+{
+  long record;
+  epn_readcontext_definition *context;
+  if(datafile->NrFreqChan > 1) {
+    printerror(verbose.debug, "ERROR readPulseEPNData: Only one freq channel is supported in this data format");
+    return 0;
+  }
+  if(datafile->epn_readcontext == NULL) {
+    if(readEPNindex(datafile, verbose) == 0) {
+      printerror(verbose.debug, "ERROR readPulseEPNData: Reading subheaders failed.");
       return 0;
     }
-    pulse[n] = (float)iprofile / scale + offset;
+  }
+  context = datafile->epn_readcontext;
+  record = pulsenr*datafile->NrPols+polarization;
+  fseek(datafile->fptr, context->recordpos[record]+160+4*binnr, SEEK_SET);
+  if(fread(context->buffer, 1, 4*nrSamples, datafile->fptr) != 4*nrSamples || internalEPNdecodeHex(context->buffer, nrSamples, context->scale[record], context->offset[record], pulse) == 0) {
+    printerror(verbose.debug, "ERROR readPulseEPNData: Reading data failed.");
+    return 0;
   }
   return 1;
 }
 int readEPNfile(datafile_definition *datafile, float *data, verbose_definition verbose, long request_only_one_pulse)
 {
-  long n, f, p;
+  long n, p, record;
+  epn_readcontext_definition *context;
   if(verbose.verbose) {
     printf("Start reading EPN file\n");
   }
+  if(datafile->NrFreqChan > 1) {
+    printerror(verbose.debug, "ERROR readEPNfile: Only one freq channel is supported in this data format");
+    return 0;
+  }
+  if(datafile->epn_readcontext == NULL) {
+    if(readEPNindex(datafile, verbose) == 0) {
+      printerror(verbose.debug, "ERROR readEPNfile: Reading subheaders failed.");
+      return 0;
+    }
+  }
+  context = datafile->epn_readcontext;
   for(n = 0; n < datafile->NrSubints; n++) {
+    if(verbose.verbose && verbose.nocounters == 0)
+      printf("  Progress reading EPN file (%.1f%%)\r", 100.0*n/(float)datafile->NrSubints);
+    fseek(datafile->fptr, n*context->buffer_size, SEEK_SET);
+    if(fread(context->buffer, 1, context->buffer_size, datafile->fptr) != context->buffer_size) {
+      printerror(verbose.debug, "ERROR readEPNfile: Read error.");
+      return 0;
+    }
     for(p = 0; p < datafile->NrPols; p++) {
-      for(f = 0; f < datafile->NrFreqChan; f++) {
-        if(verbose.verbose && verbose.nocounters == 0)
-          printf("  Progress reading EPN file (%.1f%%)\r", 100.0*(n+(f+p*datafile->NrFreqChan)*datafile->NrSubints)/(float)(datafile->NrSubints*datafile->NrFreqChan*datafile->NrPols));
- if(readPulseEPNData(datafile, n, p, f, 0, datafile->NrBins, &data[datafile->NrBins*(p+datafile->NrPols*(f+n*datafile->NrFreqChan))], verbose) == 0) {
-   printerror(verbose.debug, "ERROR readEPNfile: Read error.");
-   return 0;
- }
+      record = n*datafile->NrPols+p;
+      if(internalEPNdecodeHex(&(context->buffer[context->recordpos[record]-n*context->buffer_size+160]), datafile->NrBins, context->scale[record], context->offset[record], &data[datafile->NrBins*(p+datafile->NrPols*n)]) == 0) {
+ printerror(verbose.debug, "ERROR readEPNfile: Read error.");
+ return 0;
       }
     }
   }
@@ -330,19 +330,11 @@ int readFITSpulse_receivermodel(datafile_definition *datafile, long pulsenr, int
   }
   return 1;
 }
-int readFITSpulse(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
+int internalFITSweightmode(datafile_definition *datafile, int showwarnings, verbose_definition verbose)
 {
-  int status = 0;
-  int anynul, ret, colnum;
-  long i, istart, bstart, bsample;
-  int *data;
-  unsigned char singlebyte;
-  if(datafile->gentype == GENTYPE_RECEIVERMODEL || datafile->gentype == GENTYPE_RECEIVERMODEL2) {
-    return readFITSpulse_receivermodel(datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse, verbose);
-  }
   int weightmode;
   weightmode = 0;
-  if(pulsenr == 0 && polarization == 0 && freq == 0 && binnr == 0) {
+  if(showwarnings) {
     if(psrfits_weightmode == 1) {
       printwarning(verbose.debug, "WARNING: The data is NOT multiplied with the weight, even when set to zero. This might undo any zapping done and avoids introducing artificial intensity fluctuations IF the data is written as the weighted average rather than the sum. This will not be ideal when summing data at a later stage.");
     }else if(psrfits_weightmode == 2) {
@@ -353,7 +345,7 @@ int readFITSpulse(datafile_definition *datafile, long pulsenr, int polarization,
   }
   if(datafile->NrFreqChan == 1) {
     if(psrfits_weightmode == 0) {
-      if(datafile->weight_stats_differentweights && pulsenr == 0 && polarization == 0 && freq == 0 && binnr == 0) {
+      if(datafile->weight_stats_differentweights && showwarnings) {
  printwarning(verbose.debug, "WARNING: FITS file contains data with different weights. For data with only one frequency channel the data is NOT multiplied with the weight if it is nonzero. This avoids introducing artificial intensity fluctuations IF the data is written as the weighted average rather than the sum. This will not be ideal when summing data at a later stage. Use the -useweights option to multiply the data with the weights.");
       }
       weightmode = 2;
@@ -362,7 +354,7 @@ int readFITSpulse(datafile_definition *datafile, long pulsenr, int polarization,
     }
   }else {
     if(psrfits_weightmode == 0) {
-      if(datafile->weight_stats_differentweights && pulsenr == 0 && polarization == 0 && freq == 0 && binnr == 0) {
+      if(datafile->weight_stats_differentweights && showwarnings) {
  printwarning(verbose.debug, "WARNING: FITS file contains data with different weights. For data with multiple frequency channels the data is multiplied with the weight. This might be benificial when summing data at a later stage IF the data is written as the weighted average rather than the sum. However, it might introduce artificial intensity fluctuations as well. Use the -uniformweights to take the weights equal.");
       }
       weightmode = 3;
@@ -370,113 +362,399 @@ int readFITSpulse(datafile_definition *datafile, long pulsenr, int polarization,
       weightmode = psrfits_weightmode;
     }
   }
-  data = (int *)malloc(datafile->NrBins*sizeof(int));
-  if(data == NULL) {
-    fflush(stdout);
-    printerror(verbose.debug, "ERROR readFITSpulse: Cannot allocate memory");
+  return weightmode;
+}
+float internalFITSweight(datafile_definition *datafile, int weightmode, long subint, long freq)
+{
+  float weight;
+  weight = datafile->weights[subint*datafile->NrFreqChan+freq];
+  if(weightmode == 3) {
+    if(psrfits_absweights)
+      return fabs(weight);
+    return weight;
+  }else if(weightmode == 2 && weight == 0.0) {
     return 0;
   }
+  return 1;
+}
+void freeFITSreadcontext(datafile_definition *datafile)
+{
+  if(datafile->fits_readcontext == NULL)
+    return;
+  free(datafile->fits_readcontext->weightfactors);
+  free(datafile->fits_readcontext->datfreq);
+  free(datafile->fits_readcontext->rowbuffer);
+  free(datafile->fits_readcontext->resident);
+  free(datafile->fits_readcontext);
+  datafile->fits_readcontext = NULL;
+}
+psrfits_readcontext_definition *internalFITSreadcontext(datafile_definition *datafile, verbose_definition verbose)
+{
+  int status = 0;
+  int anynul, colnum;
+  long n, f;
+  psrfits_readcontext_definition *context;
+  if(datafile->fits_readcontext != NULL)
+    return datafile->fits_readcontext;
+  if(datafile->scales == NULL || datafile->offsets == NULL || datafile->weights == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalFITSreadcontext: Scales, offsets and weights are not read in.");
+    return NULL;
+  }
+  context = (psrfits_readcontext_definition *)calloc(1, sizeof(psrfits_readcontext_definition));
+  if(context == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalFITSreadcontext: Memory allocation error");
+    return NULL;
+  }
+  datafile->fits_readcontext = context;
+  if(fits_get_colnum(datafile->fits_fptr, CASEINSEN, "DATA", &(context->colnum_data), &status)) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalFITSreadcontext: No data in fits file?");
+    freeFITSreadcontext(datafile);
+    return NULL;
+  }
+  context->weightmode = internalFITSweightmode(datafile, 0, verbose);
+  context->weightfactors = (float *)malloc(datafile->NrSubints*datafile->NrFreqChan*sizeof(float));
+  if(context->weightfactors == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR internalFITSreadcontext: Memory allocation error");
+    freeFITSreadcontext(datafile);
+    return NULL;
+  }
+  for(n = 0; n < datafile->NrSubints; n++) {
+    for(f = 0; f < datafile->NrFreqChan; f++) {
+      context->weightfactors[n*datafile->NrFreqChan+f] = internalFITSweight(datafile, context->weightmode, n, f);
+    }
+  }
   if(psrfits_use_weighted_freq) {
     if(fits_get_colnum(datafile->fits_fptr, CASEINSEN, "DAT_FREQ", &colnum, &status)) {
       fflush(stdout);
-      printerror(verbose.debug, "ERROR readFITSpulse: No frequency column in fits file?");
-      return 0;
+      printerror(verbose.debug, "ERROR internalFITSreadcontext: No frequency column in fits file?");
+      freeFITSreadcontext(datafile);
+      return NULL;
     }
-    datafile->freqMode = FREQMODE_UNIFORM;
-    if(datafile->freqlabel_list != NULL) {
-      free(datafile->freqlabel_list);
-      datafile->freqlabel_list = NULL;
+    context->datfreq = (double *)malloc(datafile->NrSubints*sizeof(double));
+    if(context->datfreq == NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR internalFITSreadcontext: Memory allocation error");
+      freeFITSreadcontext(datafile);
+      return NULL;
     }
-    double freq;
-    if(!fits_read_col(datafile->fits_fptr, TFLOAT, colnum, 1+pulsenr, 1, 1, NULL, &freq, &anynul, &status)) {
+    for(n = 0; n < datafile->NrSubints; n++) {
+      if(fits_read_col(datafile->fits_fptr, TDOUBLE, colnum, 1+n, 1, 1, NULL, &(context->datfreq[n]), &anynul, &status)) {
+ fflush(stdout);
+ printerror(verbose.debug, "ERROR internalFITSreadcontext: Cannot read DAT_FREQ column");
+ fits_report_error(stderr, status);
+ freeFITSreadcontext(datafile);
+ return NULL;
+      }
     }
-    set_centre_frequency(datafile, freq, verbose);
-    if(set_bandwidth(datafile, 0.0, verbose) == 0) {
+  }
+  return context;
+}
+void *internalFITSrowbuffer(psrfits_readcontext_definition *context, long size, verbose_definition verbose)
+{
+  if(size > context->rowbuffer_size) {
+    free(context->rowbuffer);
+    context->rowbuffer = malloc(size);
+    if(context->rowbuffer == NULL) {
+      context->rowbuffer_size = 0;
       fflush(stdout);
-      printerror(verbose.debug, "ERROR readFITSpulse: Bandwidth changing failed");
-      return 0;
+      printerror(verbose.debug, "ERROR internalFITSrowbuffer: Cannot allocate memory");
+      return NULL;
     }
+    context->rowbuffer_size = size;
   }
-  if(fits_get_colnum(datafile->fits_fptr, CASEINSEN, "DATA", &colnum, &status)) {
+  return context->rowbuffer;
+}
+int internalFITSweightedfreq(datafile_definition *datafile, psrfits_readcontext_definition *context, long pulsenr, verbose_definition verbose)
+{
+  datafile->freqMode = FREQMODE_UNIFORM;
+  if(datafile->freqlabel_list != NULL) {
+    free(datafile->freqlabel_list);
+    datafile->freqlabel_list = NULL;
+  }
+  set_centre_frequency(datafile, context->datfreq[pulsenr], verbose);
+  if(set_bandwidth(datafile, 0.0, verbose) == 0) {
     fflush(stdout);
-    printerror(verbose.debug, "ERROR readFITSpulse: No data in fits file?");
+    printerror(verbose.debug, "ERROR readFITSpulse: Bandwidth changing failed");
+    return 0;
+  }
+  return 1;
+}
+void internalFITSunpackSamples(unsigned char *packed, int nrbits, long nrsamples, unsigned char *samples)
+{
+  long i, nrbytes;
+  unsigned char byte;
+  if(nrbits == 8) {
+    memcpy(samples, packed, nrsamples);
+  }else if(nrbits == 4) {
+    nrbytes = nrsamples/2;
+    for(i = 0; i < nrbytes; i++) {
+      samples[2*i] = packed[i] >> 4;
+      samples[2*i+1] = packed[i] & 15;
+    }
+    if(nrsamples % 2)
+      samples[nrsamples-1] = packed[nrbytes] >> 4;
+  }else if(nrbits == 2) {
+    nrbytes = nrsamples/4;
+    for(i = 0; i < nrbytes; i++) {
+      samples[4*i] = packed[i] >> 6;
+      samples[4*i+1] = (packed[i] >> 4) & 3;
+      samples[4*i+2] = (packed[i] >> 2) & 3;
+      samples[4*i+3] = packed[i] & 3;
+    }
+    if(nrsamples % 4) {
+      byte = packed[nrbytes];
+      for(i = 4*nrbytes; i < nrsamples; i++) {
+ samples[i] = byte >> 6;
+ byte <<= 2;
+      }
+    }
+  }
+}
+void internalFITSsampleTable(int nrbits, float scale, float offset, float *table)
+{
+  int i;
+  for(i = 0; i < (1 << nrbits); i++) {
+    table[i] = scale*i + offset;
+  }
+}
+int readFITSpulse(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
+{
+  int status = 0;
+  int anynul, ret;
+  long i, istart, index;
+  float scale, offset, weight;
+  psrfits_readcontext_definition *context;
+  if(datafile->gentype == GENTYPE_RECEIVERMODEL || datafile->gentype == GENTYPE_RECEIVERMODEL2) {
+    return readFITSpulse_receivermodel(datafile, pulsenr, polarization, freq, binnr, nrSamples, pulse, verbose);
+  }
+  context = internalFITSreadcontext(datafile, verbose);
+  if(context == NULL)
     return 0;
+  if(pulsenr == 0 && polarization == 0 && freq == 0 && binnr == 0) {
+    internalFITSweightmode(datafile, 1, verbose);
+  }
+  if(psrfits_use_weighted_freq) {
+    if(internalFITSweightedfreq(datafile, context, pulsenr, verbose) == 0) {
+      return 0;
+    }
   }
+  weight = context->weightfactors[pulsenr*datafile->NrFreqChan+freq];
+  if(context->weightmode == 2 && weight == 0.0) {
+    memset(pulse, 0, nrSamples*sizeof(float));
+    return 1;
+  }
+  index = pulsenr*datafile->NrPols*datafile->NrFreqChan+polarization*datafile->NrFreqChan+freq;
+  scale = datafile->scales[index]*weight;
+  offset = datafile->offsets[index]*weight;
   ret = 0;
-  if(datafile->NrBits == 16) {
+  if(datafile->NrBits == 16 && context->resident != NULL) {
+    short *data;
+    istart = polarization*datafile->NrBins*datafile->NrFreqChan+freq*datafile->NrBins+binnr;
+    data = &(((short *)(context->resident+pulsenr*context->resident_rowsize))[istart]);
+    for(i = 0; i < nrSamples; i++) {
+      pulse[i] = scale*data[i] + offset;
+    }
+    ret = 1;
+  }else if(datafile->NrBits == 16) {
+    int *data;
+    data = (int *)internalFITSrowbuffer(context, nrSamples*sizeof(int), verbose);
+    if(data == NULL)
+      return 0;
     istart = polarization*datafile->NrBins*datafile->NrFreqChan+freq*datafile->NrBins+binnr;
-    if(!fits_read_col(datafile->fits_fptr, TINT, colnum, 1+pulsenr, 1+istart, nrSamples, NULL, data, &anynul, &status)) {
+    if(!fits_read_col(datafile->fits_fptr, TINT, context->colnum_data, 1+pulsenr, 1+istart, nrSamples, NULL, data, &anynul, &status)) {
       ret = 1;
+      for(i = 0; i < nrSamples; i++) {
+ pulse[i] = scale*data[i] + offset;
+      }
     }
   }else if(datafile->NrBits == 2 || datafile->NrBits == 4 || datafile->NrBits == 8) {
-    ret = 1;
+    unsigned char *packed;
+    float table[256];
+    long stride, firstsample, firstbyte, nrbytes, bit;
+    int mask;
+    stride = datafile->NrPols*datafile->NrFreqChan;
+    firstsample = binnr*stride+polarization*datafile->NrFreqChan+freq;
+    firstbyte = firstsample*datafile->NrBits/8;
+    nrbytes = (firstsample+(nrSamples-1)*stride)*datafile->NrBits/8 - firstbyte + 1;
+    if(context->resident != NULL) {
+      packed = context->resident+pulsenr*context->resident_rowsize+firstbyte;
+    }else {
+      packed = (unsigned char *)internalFITSrowbuffer(context, nrbytes, verbose);
+      if(packed == NULL)
+ return 0;
+      if(fits_read_col(datafile->fits_fptr, TBYTE, context->colnum_data, 1+pulsenr, 1+firstbyte, nrbytes, NULL, packed, &anynul, &status))
+ packed = NULL;
+    }
+    if(packed != NULL) {
+      ret = 1;
+      internalFITSsampleTable(datafile->NrBits, scale, offset, table);
+      mask = (1 << datafile->NrBits) - 1;
+      bit = firstsample*datafile->NrBits - 8*firstbyte;
+      for(i = 0; i < nrSamples; i++) {
+ pulse[i] = table[(packed[bit >> 3] >> (8 - datafile->NrBits - (bit & 7))) & mask];
+ bit += stride*datafile->NrBits;
+      }
+    }
   }else {
     fflush(stdout);
     printerror(verbose.debug, "ERROR readFITSpulse: Unsupported number of bits.");
   }
-  if(ret == 1) {
-    float scale, offset;
-    long index = pulsenr*datafile->NrPols*datafile->NrFreqChan+polarization*datafile->NrFreqChan+freq;
-    scale = datafile->scales[index];
-    offset = datafile->offsets[index];
-    for(i = 0; i < nrSamples; i++) {
-      if(datafile->NrBits == 16) {
- pulse[i] = scale*(data[i]) + offset;
-      }else if(datafile->NrBits == 2 || datafile->NrBits == 4 || datafile->NrBits == 8) {
- istart = (binnr+i)*datafile->NrPols*datafile->NrFreqChan+polarization*datafile->NrFreqChan+freq;
- bstart = istart*datafile->NrBits;
- istart = bstart/8;
- if(!fits_read_col(datafile->fits_fptr, TBYTE, colnum, 1+pulsenr, 1+istart, 1, NULL, &singlebyte, &anynul, &status)) {
-   ret = 1;
- }
- bsample = bstart % 8;
- if(datafile->NrBits == 4) {
-   if(bsample == 0) {
-     singlebyte = singlebyte/16;
-   }else if(bsample == 4) {
-     singlebyte = singlebyte & 15;
-   }else {
-     fflush(stdout);
-     printerror(verbose.debug, "ERROR readFITSpulse: bin shift error.");
-     return 0;
-   }
- }else if(datafile->NrBits == 8) {
- }else if(datafile->NrBits == 2) {
-   if(bsample == 0) {
-     singlebyte = singlebyte/64;
-   }else if(bsample == 2) {
-     singlebyte = singlebyte & 48;
-     singlebyte = singlebyte/16;
-   }else if(bsample == 4) {
-     singlebyte = singlebyte & 12;
-     singlebyte = singlebyte/4;
-   }else if(bsample == 6) {
-     singlebyte = singlebyte & 3;
-   }else {
-     fflush(stdout);
-     printerror(verbose.debug, "ERROR readFITSpulse: bin shift error.");
-     return 0;
-   }
+  if (status) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readFITSpulse: ");
+    fits_report_error(stderr, status);
+  }
+  return ret;
+}
+int readFITSsubint(datafile_definition *datafile, long subintnr, float *subintdata, verbose_definition verbose)
+{
+  int status = 0;
+  int anynul;
+  long i, f, p, nrsamples, nrbytes, index;
+  float *pulse, scale, offset, weight;
+  psrfits_readcontext_definition *context;
+  if(datafile->gentype == GENTYPE_RECEIVERMODEL || datafile->gentype == GENTYPE_RECEIVERMODEL2) {
+    for(f = 0; f < datafile->NrFreqChan; f++) {
+      for(p = 0; p < datafile->NrPols; p++) {
+ if(readFITSpulse_receivermodel(datafile, subintnr, p, f, 0, datafile->NrBins, &subintdata[datafile->NrBins*(p+datafile->NrPols*f)], verbose) == 0)
+   return 0;
+      }
+    }
+    return 1;
+  }
+  if(datafile->NrBits != 16 && datafile->NrBits != 2 && datafile->NrBits != 4 && datafile->NrBits != 8) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readFITSsubint: Unsupported number of bits.");
+    return 0;
+  }
+  context = internalFITSreadcontext(datafile, verbose);
+  if(context == NULL)
+    return 0;
+  if(subintnr == 0) {
+    internalFITSweightmode(datafile, 1, verbose);
+  }
+  if(psrfits_use_weighted_freq) {
+    if(internalFITSweightedfreq(datafile, context, subintnr, verbose) == 0) {
+      return 0;
+    }
+  }
+  nrsamples = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan;
+  if(datafile->NrBits == 16) {
+    int *rowdata;
+    rowdata = (int *)internalFITSrowbuffer(context, nrsamples*sizeof(int), verbose);
+    if(rowdata == NULL)
+      return 0;
+    if(context->resident != NULL) {
+      short *residentdata = (short *)(context->resident+subintnr*context->resident_rowsize);
+      for(i = 0; i < nrsamples; i++)
+ rowdata[i] = residentdata[i];
+    }else if(fits_read_col(datafile->fits_fptr, TINT, context->colnum_data, 1+subintnr, 1, nrsamples, NULL, rowdata, &anynul, &status)) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readFITSsubint: Cannot read subint %ld", subintnr);
+      fits_report_error(stderr, status);
+      return 0;
+    }
+    for(p = 0; p < datafile->NrPols; p++) {
+      for(f = 0; f < datafile->NrFreqChan; f++) {
+ pulse = &subintdata[datafile->NrBins*(p+datafile->NrPols*f)];
+ weight = context->weightfactors[subintnr*datafile->NrFreqChan+f];
+ if(context->weightmode == 2 && weight == 0.0) {
+   memset(pulse, 0, datafile->NrBins*sizeof(float));
+   continue;
+ }
+ index = subintnr*datafile->NrPols*datafile->NrFreqChan+p*datafile->NrFreqChan+f;
+ scale = datafile->scales[index]*weight;
+ offset = datafile->offsets[index]*weight;
+ int *rowpulse = &rowdata[(p*datafile->NrFreqChan+f)*datafile->NrBins];
+ for(i = 0; i < datafile->NrBins; i++) {
+   pulse[i] = scale*rowpulse[i] + offset;
  }
- pulse[i] = scale*(singlebyte) + offset;
       }
-      if(weightmode == 3 && psrfits_absweights == 0) {
- pulse[i] *= datafile->weights[pulsenr*datafile->NrFreqChan+freq];
-      }else if(weightmode == 3 && psrfits_absweights != 0) {
- pulse[i] *= fabs(datafile->weights[pulsenr*datafile->NrFreqChan+freq]);
-      }else if(weightmode == 2) {
- if(datafile->weights[pulsenr*datafile->NrFreqChan+freq] == 0.0)
- pulse[i] = 0;
+    }
+  }else {
+    unsigned char *rowdata, *samples;
+    float table[256];
+    nrbytes = (nrsamples*datafile->NrBits+7)/8;
+    rowdata = (unsigned char *)internalFITSrowbuffer(context, nrbytes+nrsamples, verbose);
+    if(rowdata == NULL)
+      return 0;
+    samples = rowdata+nrbytes;
+    if(context->resident != NULL) {
+      rowdata = context->resident+subintnr*context->resident_rowsize;
+    }else if(fits_read_col(datafile->fits_fptr, TBYTE, context->colnum_data, 1+subintnr, 1, nrbytes, NULL, rowdata, &anynul, &status)) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readFITSsubint: Cannot read subint %ld", subintnr);
+      fits_report_error(stderr, status);
+      return 0;
+    }
+    internalFITSunpackSamples(rowdata, datafile->NrBits, nrsamples, samples);
+    for(p = 0; p < datafile->NrPols; p++) {
+      for(f = 0; f < datafile->NrFreqChan; f++) {
+ pulse = &subintdata[datafile->NrBins*(p+datafile->NrPols*f)];
+ weight = context->weightfactors[subintnr*datafile->NrFreqChan+f];
+ if(context->weightmode == 2 && weight == 0.0) {
+   memset(pulse, 0, datafile->NrBins*sizeof(float));
+   continue;
+ }
+ index = subintnr*datafile->NrPols*datafile->NrFreqChan+p*datafile->NrFreqChan+f;
+ internalFITSsampleTable(datafile->NrBits, datafile->scales[index]*weight, datafile->offsets[index]*weight, table);
+ unsigned char *sample = &samples[p*datafile->NrFreqChan+f];
+ for(i = 0; i < datafile->NrBins; i++) {
+   pulse[i] = table[sample[i*datafile->NrPols*datafile->NrFreqChan]];
+ }
       }
     }
   }
-  free(data);
-  if (status) {
+  return 1;
+}
+int readFITSresident(datafile_definition *datafile, verbose_definition verbose)
+{
+  int status = 0;
+  int anynul;
+  long n, nrsamples;
+  psrfits_readcontext_definition *context;
+  if(datafile->gentype == GENTYPE_RECEIVERMODEL || datafile->gentype == GENTYPE_RECEIVERMODEL2)
+    return 0;
+  if(datafile->NrBits != 16 && datafile->NrBits != 2 && datafile->NrBits != 4 && datafile->NrBits != 8)
+    return 0;
+  context = internalFITSreadcontext(datafile, verbose);
+  if(context == NULL)
+    return 0;
+  if(context->resident != NULL)
+    return 1;
+  nrsamples = datafile->NrBins*datafile->NrPols*datafile->NrFreqChan;
+  if(datafile->NrBits == 16)
+    context->resident_rowsize = nrsamples*sizeof(short);
+  else
+    context->resident_rowsize = (nrsamples*datafile->NrBits+7)/8;
+  context->resident = (unsigned char *)malloc(datafile->NrSubints*context->resident_rowsize);
+  if(context->resident == NULL) {
     fflush(stdout);
-    printerror(verbose.debug, "ERROR readFITSpulse: ");
-    fits_report_error(stderr, status);
+    printerror(verbose.debug, "ERROR readFITSresident: Cannot allocate memory (%.3fGB).", datafile->NrSubints*context->resident_rowsize/1073741824.0);
+    return 0;
   }
-  return ret;
+  if(verbose.verbose) {
+    printf("Keeping %.3fGB of %d-bit samples in memory\n", datafile->NrSubints*context->resident_rowsize/1073741824.0, datafile->NrBits);
+  }
+  for(n = 0; n < datafile->NrSubints; n++) {
+    if(datafile->NrBits == 16)
+      fits_read_col(datafile->fits_fptr, TSHORT, context->colnum_data, 1+n, 1, nrsamples, NULL, context->resident+n*context->resident_rowsize, &anynul, &status);
+    else
+      fits_read_col(datafile->fits_fptr, TBYTE, context->colnum_data, 1+n, 1, context->resident_rowsize, NULL, context->resident+n*context->resident_rowsize, &anynul, &status);
+    if(status) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readFITSresident: Cannot read subint %ld", n);
+      fits_report_error(stderr, status);
+      free(context->resident);
+      context->resident = NULL;
+      return 0;
+    }
+  }
+  return 1;
 }
 int readPSRCHIVE_ASCIIHeader(datafile_definition *datafile, verbose_definition verbose)
 {
@@ -2836,8 +3114,11 @@ int readPSRFITSHeader(datafile_definition *datafile, int readnoscales, int nowar
     }
     if(readnoscales)
       return 1;
-    else
-      return readPSRFITSscales(datafile, verbose);
+    if(readPSRFITSscales(datafile, verbose) == 0)
+      return 0;
+    if(internalFITSreadcontext(datafile, verbose) == NULL)
+      return 0;
+    return 1;
   }
   if(nodata) {
     if(fits_movnam_hdu(datafile->fits_fptr, BINARY_TBL, "FEEDPAR", 0, &status)) {
@@ -3152,7 +3433,7 @@ int writeFITSfile(datafile_definition datafile, float *data, verbose_definition
 }
 int readFITSfile(datafile_definition *datafile, float *data, verbose_definition verbose)
 {
-  long n, f, p, i;
+  long n, i;
   if(verbose.verbose) {
     for(i = 0; i < verbose.indent; i++)
       printf(" ");
@@ -3165,14 +3446,10 @@ int readFITSfile(datafile_definition *datafile, float *data, verbose_definition
       printf("  subint %ld/%ld (%.1f%%)\r", n+1, datafile->NrSubints, 100.0*(n+1)/(float)datafile->NrSubints);
       fflush(stdout);
     }
-    for(f = 0; f < datafile->NrFreqChan; f++) {
-      for(p = 0; p < datafile->NrPols; p++) {
- if(readFITSpulse(datafile, n, p, f, 0, datafile->NrBins, &data[datafile->NrBins*(p+datafile->NrPols*(f+n*datafile->NrFreqChan))], verbose) == 0) {
-     fflush(stdout);
-     printerror(verbose.debug, "ERROR readFITSfile: Cannot read data  (n=%ld f=%ld p=%ld)             ", n, f, p);
-     return 0;
-   }
-      }
+    if(readFITSsubint(datafile, n, &data[datafile->NrBins*datafile->NrPols*datafile->NrFreqChan*n], verbose) == 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR readFITSfile: Cannot read data  (n=%ld)             ", n);
+      return 0;
     }
   }
   if(verbose.verbose) {
@@ -3182,67 +3459,77 @@ int readFITSfile(datafile_definition *datafile, float *data, verbose_definition
   }
   return 1;
 }
+char *internalASCIInextWord(char *ptr)
+{
+  while(*ptr == ' ' || *ptr == '\t' || *ptr == '\n' || *ptr == '\r')
+    ptr++;
+  return ptr;
+}
 int readPSRCHIVE_ASCIIfile(datafile_definition datafile, float *data, verbose_definition verbose)
 {
-  char txt[100];
-  int ret;
-  long n, f, i, p;
-  float sample;
+  long n, f, i, p, j, size, allocated;
+  char *buffer, *newbuffer, *ptr, *endptr;
+  allocated = 1048576;
+  size = 0;
+  buffer = malloc(allocated+1);
+  if(buffer == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Memory allocation error.");
+    return 0;
+  }
+  while((j = fread(buffer+size, 1, allocated-size, datafile.fptr)) > 0) {
+    size += j;
+    if(size == allocated) {
+      allocated *= 2;
+      newbuffer = realloc(buffer, allocated+1);
+      if(newbuffer == NULL) {
+ fflush(stdout);
+ printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Memory allocation error.");
+ free(buffer);
+ return 0;
+      }
+      buffer = newbuffer;
+    }
+  }
+  buffer[size] = 0;
+  ptr = buffer;
   for(n = 0; n < datafile.NrSubints; n++) {
     if(verbose.verbose && verbose.nocounters == 0) printf("readPSRCHIVE_ASCIIfile: pulse %ld/%ld\r", n+1, datafile.NrSubints);
     for(f = 0; f < datafile.NrFreqChan; f++) {
       for(i = 0; i < datafile.NrBins; i++) {
- ret = fscanf(datafile.fptr, "%s", txt);
- if(ret != 1) {
-   fflush(stdout);
-   printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Read error. File not in right format (not generated with \"pdv -t\"?) (%s != 0).", txt);
-   return 0;
- }
- if(i == 0 && f == 0 && n == 0) {
-   if(strcmp(txt, "0") != 0) {
-     fflush(stdout);
-     printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: File not in right format (not generated with \"pdv -t\"?) (%s != 0).", txt);
-     return 0;
-   }
- }
- ret = fscanf(datafile.fptr, "%s", txt);
- if(ret != 1) {
-   fflush(stdout);
-   printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Read error. File not in right format (not generated with \"pdv -t\"?) (%s != 0).", txt);
-   return 0;
- }
- if(i == 0 && f == 0 && n == 0) {
-   if(strcmp(txt, "0") != 0) {
+ for(j = 0; j < 3; j++) {
+   ptr = internalASCIInextWord(ptr);
+   if(*ptr == 0) {
      fflush(stdout);
-     printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: File not in right format (not generated with \"pdv -t\"?) (%s != 0).",txt );
+     printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Read error. File not in right format (not generated with \"pdv -t\"?).");
+     free(buffer);
      return 0;
    }
- }
- ret = fscanf(datafile.fptr, "%s", txt);
- if(ret != 1) {
-   fflush(stdout);
-   printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Read error. File not in right format (not generated with \"pdv -t\"?) (%s != 0).", txt);
-   return 0;
- }
- if(i == 0 && f == 0 && n == 0) {
-   if(strcmp(txt, "0") != 0) {
-     fflush(stdout);
-     printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: File not in right format (not generated with \"pdv -t\"?) (%s != 0).", txt);
-     return 0;
+   if(i == 0 && f == 0 && n == 0) {
+     if(ptr[0] != '0' || (ptr[1] != ' ' && ptr[1] != '\t' && ptr[1] != '\n' && ptr[1] != '\r' && ptr[1] != 0)) {
+       fflush(stdout);
+       printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: File not in right format (not generated with \"pdv -t\"?) (%.20s != 0).", ptr);
+       free(buffer);
+       return 0;
+     }
    }
+   while(*ptr != 0 && *ptr != ' ' && *ptr != '\t' && *ptr != '\n' && *ptr != '\r')
+     ptr++;
  }
  for(p = 0; p < datafile.NrPols; p++) {
-   ret = fscanf(datafile.fptr, "%f", &sample);
-   if(ret != 1) {
+   data[datafile.NrBins*(p+datafile.NrPols*(f+n*datafile.NrFreqChan))+i] = strtof(ptr, &endptr);
+   if(endptr == ptr) {
      fflush(stdout);
-     printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Read error. File not in right format (not generated with \"pdv -t\"?) (%s != 0).", txt);
+     printerror(verbose.debug, "ERROR readPSRCHIVE_ASCIIfile: Read error. File not in right format (not generated with \"pdv -t\"?).");
+     free(buffer);
      return 0;
    }
-   data[datafile.NrBins*(p+datafile.NrPols*(f+n*datafile.NrFreqChan))+i] = sample;
+   ptr = endptr;
  }
       }
     }
   }
+  free(buffer);
   if(verbose.verbose) printf("Reading is done.                           \n");
   return 1;
 }
@@ -0,0 +1,149 @@
+/*
+Copyright (c) 2015, Patrick Weltevrede
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _FILE_OFFSET_BITS 64
+#define _USE_LARGEFILE 1
+#define _LARGEFILE_SOURCE 1
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "psrsalsa.h"
+int writePSRSALSAHeader(datafile_definition *datafile, verbose_definition verbose);
+int writeHistoryPSRSALSA(datafile_definition *datafile, verbose_definition verbose);
+int readPSRSALSAHeader(datafile_definition *datafile, int nohistory_expected, verbose_definition verbose);
+static char *headercache_directory = NULL;
+void headercache_set_directory(char *directory)
+{
+  headercache_directory = directory;
+}
+int internalHeaderCacheKey(datafile_definition *datafile, char *path, char *entryname, long long *filesize, long long *mtime)
+{
+  struct stat filestat;
+  unsigned long long hash;
+  int i;
+  if(headercache_directory == NULL || datafile->filename == NULL)
+    return 0;
+  if(realpath(datafile->filename, path) == NULL)
+    return 0;
+  if(stat(path, &filestat) != 0)
+    return 0;
+  *filesize = filestat.st_size;
+  *mtime = filestat.st_mtime;
+  hash = 14695981039346656037ULL;
+  for(i = 0; path[i] != 0; i++) {
+    hash ^= (unsigned char)path[i];
+    hash *= 1099511628211ULL;
+  }
+  if(snprintf(entryname, PATH_MAX, "%s/%016llx.hdr", headercache_directory, hash) >= PATH_MAX)
+    return 0;
+  return 1;
+}
+int readHeaderCachePSRData(datafile_definition *datafile, verbose_definition verbose)
+{
+  char path[PATH_MAX], entryname[PATH_MAX], identifier[17], *cachedpath;
+  long long filesize, mtime, cachedsize, cachedmtime, datastart;
+  int pathlength, format, version, ret;
+  FILE *fptr, *fptr_hdr;
+  if(internalHeaderCacheKey(datafile, path, entryname, &filesize, &mtime) == 0)
+    return 0;
+  fptr = fopen(entryname, "rb");
+  if(fptr == NULL)
+    return 0;
+  cachedpath = NULL;
+  ret = 0;
+  if(fread(identifier, 1, 16, fptr) == 16 && fread(&pathlength, sizeof(int), 1, fptr) == 1 && pathlength > 0 && pathlength < PATH_MAX) {
+    identifier[16] = 0;
+    cachedpath = malloc(pathlength+1);
+    if(strcmp(identifier, "PSRSALSAhdrcache") == 0 && cachedpath != NULL && fread(cachedpath, 1, pathlength, fptr) == pathlength) {
+      cachedpath[pathlength] = 0;
+      if(fread(&cachedsize, sizeof(long long), 1, fptr) == 1 && fread(&cachedmtime, sizeof(long long), 1, fptr) == 1 && fread(&format, sizeof(int), 1, fptr) == 1) {
+ if(strcmp(cachedpath, path) == 0 && cachedsize == filesize && cachedmtime == mtime && format == datafile->format)
+   ret = 1;
+      }
+    }
+  }
+  free(cachedpath);
+  if(ret) {
+    verbose_definition noverbose;
+    copyVerboseState(verbose, &noverbose);
+    noverbose.verbose = 0;
+    fptr_hdr = datafile->fptr_hdr;
+    datastart = datafile->datastart;
+    version = datafile->version;
+    datafile->fptr_hdr = fptr;
+    ret = readPSRSALSAHeader(datafile, 0, noverbose);
+    datafile->fptr_hdr = fptr_hdr;
+    datafile->datastart = datastart;
+    datafile->version = version;
+  }
+  fclose(fptr);
+  if(ret) {
+    datafile->weight_stats_set = 1;
+    datafile->weight_stats_zeroweightfound = 0;
+    datafile->weight_stats_differentweights = 0;
+    datafile->weight_stats_negativeweights = 0;
+    datafile->weight_stats_weightvalue = 1.0;
+    if(verbose.debug) {
+      printf("  Header of %s taken from cache %s\n", datafile->filename, entryname);
+    }
+  }
+  return ret;
+}
+int writeHeaderCachePSRData(datafile_definition *datafile, verbose_definition verbose)
+{
+  char path[PATH_MAX], entryname[PATH_MAX], tmpname[PATH_MAX+32];
+  long long filesize, mtime, datastart;
+  int pathlength, ret, version;
+  FILE *fptr, *fptr_hdr;
+  verbose_definition noverbose;
+  if(internalHeaderCacheKey(datafile, path, entryname, &filesize, &mtime) == 0)
+    return 0;
+  sprintf(tmpname, "%s.%ld", entryname, (long)getpid());
+  fptr = fopen(tmpname, "wb");
+  if(fptr == NULL) {
+    fflush(stdout);
+    printwarning(verbose.debug, "WARNING writeHeaderCachePSRData: Cannot create %s in header cache.", tmpname);
+    return 0;
+  }
+  pathlength = strlen(path);
+  ret = 0;
+  if(fwrite("PSRSALSAhdrcache", 1, 16, fptr) == 16 && fwrite(&pathlength, sizeof(int), 1, fptr) == 1 && fwrite(path, 1, pathlength, fptr) == pathlength && fwrite(&filesize, sizeof(long long), 1, fptr) == 1 && fwrite(&mtime, sizeof(long long), 1, fptr) == 1 && fwrite(&(datafile->format), sizeof(int), 1, fptr) == 1) {
+    copyVerboseState(verbose, &noverbose);
+    noverbose.verbose = 0;
+    fptr_hdr = datafile->fptr_hdr;
+    datastart = datafile->datastart;
+    version = datafile->version;
+    datafile->fptr_hdr = fptr;
+    ret = writePSRSALSAHeader(datafile, noverbose);
+    if(ret)
+      ret = writeHistoryPSRSALSA(datafile, noverbose);
+    datafile->fptr_hdr = fptr_hdr;
+    datafile->datastart = datastart;
+    datafile->version = version;
+  }
+  if(fclose(fptr) != 0)
+    ret = 0;
+  if(ret == 0 || rename(tmpname, entryname) != 0) {
+    remove(tmpname);
+    fflush(stdout);
+    printwarning(verbose.debug, "WARNING writeHeaderCachePSRData: Cannot write %s in header cache.", entryname);
+    return 0;
+  }
+  return 1;
+}
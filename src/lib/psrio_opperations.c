@@ -15,7 +15,118 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
 #include "psrsalsa.h"
+unsigned short internalFloatToFloat16(float value)
+{
+  union {
+    float f;
+    unsigned int u;
+  }v;
+  unsigned int sign, mantissa, half, rem, halfway;
+  int exponent, shift;
+  v.f = value;
+  sign = (v.u >> 16) & 0x8000;
+  mantissa = v.u & 0x7fffff;
+  if(((v.u >> 23) & 0xff) == 0xff)
+    return sign | 0x7c00 | (mantissa ? 0x200 : 0);
+  exponent = (int)((v.u >> 23) & 0xff) - 112;
+  if(exponent >= 31)
+    return sign | 0x7c00;
+  if(exponent <= 0) {
+    if(exponent < -10)
+      return sign;
+    mantissa |= 0x800000;
+    shift = 14 - exponent;
+    half = mantissa >> shift;
+    rem = mantissa & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+    if(rem > halfway || (rem == halfway && (half & 1)))
+      half++;
+    return sign | half;
+  }
+  half = sign | (exponent << 10) | (mantissa >> 13);
+  rem = mantissa & 0x1fff;
+  if(rem > 0x1000 || (rem == 0x1000 && (half & 1)))
+    half++;
+  return half;
+}
+float internalFloat16ToFloat(unsigned short value)
+{
+  union {
+    float f;
+    unsigned int u;
+  }v;
+  unsigned int sign, mantissa;
+  int exponent;
+  sign = (value & 0x8000u) << 16;
+  exponent = (value >> 10) & 0x1f;
+  mantissa = value & 0x3ff;
+  if(exponent == 0) {
+    if(mantissa == 0) {
+      v.u = sign;
+    }else {
+      exponent = 1;
+      while((mantissa & 0x400) == 0) {
+ mantissa <<= 1;
+ exponent--;
+      }
+      mantissa &= 0x3ff;
+      v.u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+  }else if(exponent == 31) {
+    v.u = sign | 0x7f800000 | (mantissa << 13);
+  }else {
+    v.u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  return v.f;
+}
+void convertFloatToHalf(float *src, unsigned short *dst, long nelem, int halftype)
+{
+  long i;
+  unsigned int u;
+  i = 0;
+  if(halftype == HALFTYPE_BFLOAT16) {
+    for(; i < nelem; i++) {
+      memcpy(&u, &src[i], sizeof(unsigned int));
+      if((u & 0x7f800000) == 0x7f800000 && (u & 0x7fffff))
+ dst[i] = (u >> 16) | 0x40;
+      else
+ dst[i] = (u + 0x7fff + ((u >> 16) & 1)) >> 16;
+    }
+  }else {
+#ifdef __F16C__
+    for(; i+8 <= nelem; i += 8) {
+      _mm_storeu_si128((__m128i *)&dst[i], _mm256_cvtps_ph(_mm256_loadu_ps(&src[i]), _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+    for(; i < nelem; i++)
+      dst[i] = internalFloatToFloat16(src[i]);
+  }
+}
+void convertHalfToFloat(unsigned short *src, float *dst, long nelem, int halftype)
+{
+  long i;
+  unsigned int u;
+  i = 0;
+  if(halftype == HALFTYPE_BFLOAT16) {
+    for(; i < nelem; i++) {
+      u = ((unsigned int)src[i]) << 16;
+      memcpy(&dst[i], &u, sizeof(float));
+    }
+  }else {
+#ifdef __F16C__
+    for(; i+8 <= nelem; i += 8) {
+      _mm256_storeu_ps(&dst[i], _mm256_cvtph_ps(_mm_loadu_si128((__m128i *)&src[i])));
+    }
+#endif
+    for(; i < nelem; i++)
+      dst[i] = internalFloat16ToFloat(src[i]);
+  }
+}
 int rebinPulse(float *Ipulse, long NrBins, float *Ipulse2, long NrBins2, int noDependencyWarning, verbose_definition verbose)
 {
   long j, i1, i2;
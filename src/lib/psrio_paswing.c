@@ -458,7 +458,7 @@ int make_paswing_fromIQUV(datafile_definition *datafile, int extended, pulselong
       }
     }
   }
-  free(datafile->data);
+  free_data_PSRData(datafile, verbose);
   datafile->data = newdata;
   if(rms_file_specified) {
     free(newdata_rms);
@@ -86,6 +86,180 @@ int preprocess_rebin(datafile_definition original, datafile_definition *clone, l
   }
   return 1;
 }
+int preprocess_scrunch(datafile_definition original, datafile_definition *clone, long nrfreq, long nrpulses, int complete, int *fzapMask, long NrBins, verbose_definition verbose)
+{
+  long p, f, n, f2, n2, b, nrbins_in, firstchan, lastchan, firstsubint, lastsubint;
+  float *addedpulse, *pulse;
+  double curtsub;
+  int i;
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("Scrunching data in a single pass:");
+    if(nrfreq > 0)
+      printf(" add %ld succesive frequency channels", nrfreq);
+    if(nrpulses > 0)
+      printf(" add %ld succesive subints", nrpulses);
+    if(NrBins > 0)
+      printf(" rebin to %ld bins", NrBins);
+    printf("\n");
+  }
+  if(original.format != MEMORY_format) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_scrunch: only works if data is loaded into memory.");
+    return 0;
+  }
+  if(original.poltype == POLTYPE_ILVPAdPA || original.poltype == POLTYPE_PAdPA || original.poltype == POLTYPE_ILVPAdPATEldEl) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_scrunch: Cannot handle position angle data when scrunching. Scrunch using Stokes parameter data.");
+    return 0;
+  }
+  if(original.freqMode != FREQMODE_UNIFORM) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_scrunch: Only data with a uniform frequency labelling can be scrunched in a single pass.");
+    return 0;
+  }
+  if(nrfreq < 0 || nrfreq > original.NrFreqChan || nrpulses < 0 || nrpulses > original.NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_scrunch: Invalid number of frequency channels or subints to add.");
+    return 0;
+  }
+  if(NrBins > original.NrBins) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_scrunch: Cannot rebin to a larger amount of bins.");
+    return 0;
+  }
+  if(nrfreq == 0)
+    nrfreq = 1;
+  if(NrBins <= 0)
+    NrBins = original.NrBins;
+  if(original.NrBins % NrBins != 0) {
+    fflush(stdout);
+    printwarning(verbose.debug, "WARNING preprocess_scrunch: Rebinning from %ld to %ld bins implies that separate bins are not entirely independent.", original.NrBins, NrBins);
+  }
+  if(nrpulses > 1 && original.NrPols == 4 && original.isDePar == -1) {
+    fflush(stdout);
+    printwarning(verbose.debug, "WARNING preprocess_scrunch: Parallactic angle correction state is unknown, no correction will be done.");
+  }
+  nrbins_in = original.NrBins;
+  cleanPSRData(clone, verbose);
+  copy_params_PSRData(original, clone, verbose);
+  clone->NrFreqChan = original.NrFreqChan/nrfreq;
+  if(clone->NrFreqChan * nrfreq != original.NrFreqChan) {
+    fflush(stdout);
+    printwarning(verbose.debug, "WARNING preprocess_scrunch: Last channel will be the sum of a different number of channels compared to the others. The frequency labeling will no longer be correct.");
+  }
+  if(nrpulses > 0) {
+    clone->NrSubints = original.NrSubints/nrpulses;
+    if(complete == 0) {
+      if(clone->NrSubints * nrpulses != original.NrSubints) {
+ printwarning(verbose.debug, "WARNING preprocess_scrunch: Last subint has a different duration.");
+ clone->NrSubints += 1;
+      }
+    }
+    clone->tsubMode = TSUBMODE_TSUBLIST;
+    if(clone->tsub_list != NULL)
+      free(clone->tsub_list);
+    clone->tsub_list = (double *)malloc(clone->NrSubints * sizeof(double));
+    if(clone->tsub_list == NULL) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_scrunch: Memory allocation error");
+      return 0;
+    }
+    if(clone->gentype == GENTYPE_PULSESTACK) {
+      clone->gentype = GENTYPE_SUBINTEGRATIONS;
+    }
+    if(clone->gentype == GENTYPE_SUBINTEGRATIONS && clone->NrSubints == 1) {
+      clone->gentype = GENTYPE_PROFILE;
+    }
+    if(clone->gentype != GENTYPE_PROFILE && clone->gentype != GENTYPE_SUBINTEGRATIONS && clone->gentype != GENTYPE_PULSESTACK && clone->gentype != GENTYPE_UNDEFINED && clone->gentype != GENTYPE_POLNCAL) {
+      fflush(stdout);
+      printwarning(verbose.debug, "WARNING preprocess_scrunch: Unsure about adding subints for a %s file. Setting gentype to undefined.", returnGenType_str(clone->gentype));
+      clone->gentype = GENTYPE_UNDEFINED;
+    }
+  }
+  clone->fixedtsamp *= original.NrBins/(double)NrBins;
+  clone->NrBins = NrBins;
+  clone->format = MEMORY_format;
+  clone->data = (float *)malloc((clone->NrBins)*(clone->NrPols)*(clone->NrFreqChan)*(clone->NrSubints)*sizeof(float));
+  addedpulse = (float *)malloc(nrbins_in*sizeof(float));
+  if(clone->data == NULL || addedpulse == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_scrunch: Memory allocation error.");
+    if(addedpulse != NULL)
+      free(addedpulse);
+    if(clone->data != NULL) {
+      free(clone->data);
+      clone->data = NULL;
+    }
+    if(nrpulses > 0) {
+      free(clone->tsub_list);
+      clone->tsub_list = NULL;
+    }
+    return 0;
+  }
+  for(n = 0; n < clone->NrSubints; n++) {
+    if(nrpulses > 0) {
+      firstsubint = n*nrpulses;
+      lastsubint = firstsubint+nrpulses;
+      if(lastsubint > original.NrSubints)
+ lastsubint = original.NrSubints;
+      curtsub = 0;
+      for(n2 = firstsubint; n2 < lastsubint; n2++)
+ curtsub += get_tsub(original, n2, verbose);
+      clone->tsub_list[n] = curtsub;
+    }else {
+      firstsubint = n;
+      lastsubint = n+1;
+    }
+    for(f = 0; f < clone->NrFreqChan; f++) {
+      firstchan = f*nrfreq;
+      lastchan = firstchan+nrfreq;
+      for(p = 0; p < clone->NrPols; p++) {
+ for(b = 0; b < nrbins_in; b++)
+   addedpulse[b] = 0;
+ for(n2 = firstsubint; n2 < lastsubint; n2++) {
+   for(f2 = firstchan; f2 < lastchan; f2++) {
+     if(fzapMask != NULL) {
+       if(fzapMask[f2] != 0)
+  continue;
+     }
+     pulse = &(original.data[nrbins_in*(p+original.NrPols*(f2+n2*original.NrFreqChan))]);
+     for(b = 0; b < nrbins_in; b++)
+       addedpulse[b] += pulse[b];
+   }
+ }
+ if(NrBins == nrbins_in) {
+   memcpy(&(clone->data[NrBins*(p+clone->NrPols*(f+n*clone->NrFreqChan))]), addedpulse, NrBins*sizeof(float));
+ }else {
+   if(!rebinPulse(addedpulse, nrbins_in, &(clone->data[NrBins*(p+clone->NrPols*(f+n*clone->NrFreqChan))]), NrBins, 1, verbose)) {
+     free(addedpulse);
+     free(clone->data);
+     clone->data = NULL;
+     if(nrpulses > 0) {
+       free(clone->tsub_list);
+       clone->tsub_list = NULL;
+     }
+     return 0;
+   }
+ }
+      }
+    }
+    if(verbose.verbose && verbose.nocounters == 0) {
+      for(i = 0; i < verbose.indent; i++)
+ printf(" ");
+      printf("  %.1f%%     \r", (100.0*(n+1))/(float)(clone->NrSubints));
+      fflush(stdout);
+    }
+  }
+  free(addedpulse);
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("  done                            \n");
+  }
+  return 1;
+}
 int preprocess_checknan(datafile_definition original, int generate_warning, verbose_definition verbose)
 {
   long p, f, n, b;
@@ -160,7 +334,7 @@ int preprocess_checkinf(datafile_definition original, int generate_warning, verb
 }
 int preprocess_fftshift(datafile_definition original, long singlesubint, float shiftPhase, int addslope, float slope, verbose_definition verbose)
 {
-  long p, f, n;
+  long n, nrprofiles;
   int i;
   float offset;
   if(verbose.verbose) {
@@ -181,34 +355,25 @@ int preprocess_fftshift(datafile_definition original, long singlesubint, float s
     printerror(verbose.debug, "ERROR preprocess_fftshift: Cannot handle PA data.");
     return 0;
   }
-  for(p = 0; p < original.NrPols; p++) {
-    for(f = 0; f < original.NrFreqChan; f++) {
-      for(n = 0; n < original.NrSubints; n++) {
- if(singlesubint >= 0)
-   n = singlesubint;
- if(addslope) {
-   offset = (shiftPhase+n*slope)*original.NrBins;
- }else {
-   offset = shiftPhase*original.NrBins;
- }
- if(rotateSinglepulse(&(original.data[original.NrBins*(p+original.NrPols*(f+n*original.NrFreqChan))]), original.NrBins, offset, verbose) == 0)
-   return 0;
-        if(verbose.verbose && verbose.nocounters == 0) {
-   long doprint;
-   doprint = 1;
-   if(original.NrFreqChan > 4 && n != 0)
-     doprint = 0;
-   if(doprint) {
-     for(i = 0; i < verbose.indent; i++)
-       printf(" ");
-     printf("  %.1f%%     \r", (100.0*((p*original.NrFreqChan+f)*original.NrSubints+n))/(float)(original.NrSubints*original.NrFreqChan*original.NrPols));
-     fflush(stdout);
-   }
- }
- if(singlesubint >= 0)
-   break;
-      }
+  nrprofiles = original.NrPols*original.NrFreqChan;
+  for(n = 0; n < original.NrSubints; n++) {
+    if(singlesubint >= 0)
+      n = singlesubint;
+    if(addslope) {
+      offset = (shiftPhase+n*slope)*original.NrBins;
+    }else {
+      offset = shiftPhase*original.NrBins;
+    }
+    if(shiftSinglepulseBatch(&(original.data[original.NrBins*nrprofiles*n]), original.NrBins, nrprofiles, nrprofiles, &offset, verbose) == 0)
+      return 0;
+    if(verbose.verbose && verbose.nocounters == 0) {
+      for(i = 0; i < verbose.indent; i++)
+ printf(" ");
+      printf("  %.1f%%     \r", (100.0*(n+1))/(float)(original.NrSubints));
+      fflush(stdout);
     }
+    if(singlesubint >= 0)
+      break;
   }
   if(verbose.verbose && verbose.nocounters == 0) {
     for(i = 0; i < verbose.indent; i++)
@@ -356,6 +521,128 @@ int preprocess_polselect(datafile_definition original, datafile_definition *clon
   }
   return 1;
 }
+int preprocess_select_inplace(datafile_definition *original, long nskip, long nread, long chanelnr, long polnr, verbose_definition verbose)
+{
+  long p, f, n, p_src, f_src, nrpols, nrfreqchan, nrbins;
+  int i;
+  double freq, bw;
+  float *newdata;
+  freq = 0;
+  bw = 0;
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("Selecting pulses %ld-%ld", nskip, nread+nskip-1);
+    if(chanelnr >= 0)
+      printf(", frequency channel %ld", chanelnr);
+    if(polnr >= 0)
+      printf(", polarization channel %ld", polnr);
+    printf(" in place\n");
+  }
+  if(original->format != MEMORY_format) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_select_inplace: only works if data is loaded into memory.");
+    return 0;
+  }
+  if(original->poltype == POLTYPE_ILVPAdPA || original->poltype == POLTYPE_PAdPA || original->poltype == POLTYPE_ILVPAdPATEldEl) {
+    if(nskip != 0 || nread != original->NrSubints || chanelnr >= 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_select_inplace: Cannot handle PA data.");
+      return 0;
+    }
+  }
+  if(nskip < 0 || nskip >= original->NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_select_inplace: Invalid nskip.");
+    return 0;
+  }
+  if(nread < 0 || nskip+nread > original->NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_select_inplace: Invalid nread.");
+    return 0;
+  }
+  if(chanelnr >= original->NrFreqChan) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_select_inplace: Invalid frequency chanel number.");
+    return 0;
+  }
+  if(polnr >= original->NrPols) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_select_inplace: Invalid polarization chanel number.");
+    return 0;
+  }
+  if(original->freqMode != FREQMODE_UNIFORM) {
+    if((nskip != 0 || nread != original->NrSubints) || (chanelnr >= 0 && original->NrSubints > 1)) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_select_inplace: Frequency channels are not necessarily uniformly separated.");
+      return 0;
+    }
+  }
+  nrbins = original->NrBins;
+  nrpols = original->NrPols;
+  nrfreqchan = original->NrFreqChan;
+  if(polnr >= 0)
+    nrpols = 1;
+  if(chanelnr >= 0) {
+    nrfreqchan = 1;
+    freq = get_weighted_channel_freq(*original, 0, chanelnr, verbose);
+    if(get_channelbandwidth(*original, &bw, verbose) == 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_select_inplace: Gatting bandwidth failed.");
+      return 0;
+    }
+  }
+  for(n = 0; n < nread; n++) {
+    for(f = 0; f < nrfreqchan; f++) {
+      f_src = f;
+      if(chanelnr >= 0)
+ f_src = chanelnr;
+      for(p = 0; p < nrpols; p++) {
+ p_src = p;
+ if(polnr >= 0)
+   p_src = polnr;
+ memmove(&(original->data[nrbins*(p+nrpols*(f+n*nrfreqchan))]), &(original->data[nrbins*(p_src+original->NrPols*(f_src+(n+nskip)*original->NrFreqChan))]), nrbins*sizeof(float));
+      }
+    }
+  }
+  if(original->data_mmap == NULL) {
+    newdata = (float *)realloc(original->data, nrbins*nrpols*nrfreqchan*nread*sizeof(float));
+    if(newdata != NULL)
+      original->data = newdata;
+  }
+  if(original->tsubMode == TSUBMODE_TSUBLIST && nskip > 0)
+    memmove(original->tsub_list, &(original->tsub_list[nskip]), nread*sizeof(double));
+  if(chanelnr >= 0) {
+    original->freqMode = FREQMODE_UNIFORM;
+    if(original->freqlabel_list != NULL) {
+      free(original->freqlabel_list);
+      original->freqlabel_list = NULL;
+    }
+    set_centre_frequency(original, freq, verbose);
+    if(set_bandwidth(original, bw, verbose) == 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_select_inplace: Bandwidth changing failed.");
+      return 0;
+    }
+  }
+  if(original->weights != NULL) {
+    free(original->weights);
+    original->weights = NULL;
+  }
+  if(original->offpulse_rms != NULL) {
+    free(original->offpulse_rms);
+    original->offpulse_rms = NULL;
+  }
+  original->NrSubints = nread;
+  original->NrFreqChan = nrfreqchan;
+  original->NrPols = nrpols;
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("  done\n");
+  }
+  return 1;
+}
 int preprocess_pulsesselect(datafile_definition original, datafile_definition *clone, long nskip, long nread, verbose_definition verbose)
 {
   long p, f, n, i;
@@ -434,6 +721,124 @@ int preprocess_pulsesselect(datafile_definition original, datafile_definition *c
   }
   return 1;
 }
+int preprocess_hyperslab(datafile_definition original, datafile_definition *clone, long nskip, long nread, long chanelnr, long polnr, verbose_definition verbose)
+{
+  long p, f, n, i, pc, fc;
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("Reading pulses %ld-%ld", nskip, nread+nskip-1);
+    if(chanelnr >= 0)
+      printf(", frequency channel %ld", chanelnr);
+    if(polnr >= 0)
+      printf(", polarization channel %ld", polnr);
+    printf("\n");
+  }
+  if(nskip < 0 || nskip >= original.NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_hyperslab: Invalid nskip.");
+    return 0;
+  }
+  if(nread < 0 || nskip+nread > original.NrSubints) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_hyperslab: Invalid nread.");
+    return 0;
+  }
+  if(nskip != 0 || nread != original.NrSubints || chanelnr >= 0) {
+    if(original.poltype == POLTYPE_ILVPAdPA || original.poltype == POLTYPE_PAdPA || original.poltype == POLTYPE_ILVPAdPATEldEl) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_hyperslab: Cannot handle PA data.");
+      return 0;
+    }
+  }
+  if((nskip != 0 || nread != original.NrSubints) && original.freqMode != FREQMODE_UNIFORM) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_hyperslab: Frequency channels are not necessarily uniformly separated.");
+    return 0;
+  }
+  if(chanelnr >= 0) {
+    if(chanelnr >= original.NrFreqChan) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_hyperslab: Invalid frequency chanel number.");
+      return 0;
+    }
+    if(nread > 1 && original.freqMode != FREQMODE_UNIFORM) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_hyperslab: Selecting single frequency channels from a multi-subint dataset is only implemented when the frequency channels are uniformely separated.");
+      return 0;
+    }
+  }
+  if(polnr >= original.NrPols) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_hyperslab: Invalid polarization chanel number.");
+    return 0;
+  }
+  cleanPSRData(clone, verbose);
+  copy_params_PSRData(original, clone, verbose);
+  clone->format = MEMORY_format;
+  clone->NrSubints = nread;
+  if(polnr >= 0)
+    clone->NrPols = 1;
+  if(chanelnr >= 0) {
+    double bw;
+    clone->NrFreqChan = 1;
+    clone->freqMode = FREQMODE_UNIFORM;
+    if(clone->freqlabel_list != NULL) {
+      free(clone->freqlabel_list);
+      clone->freqlabel_list = NULL;
+    }
+    set_centre_frequency(clone, get_weighted_channel_freq(original, nskip, chanelnr, verbose), verbose);
+    if(get_channelbandwidth(original, &bw, verbose) == 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_hyperslab: Gatting bandwidth failed.");
+      return 0;
+    }
+    if(set_bandwidth(clone, bw, verbose) == 0) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_hyperslab: Bandwidth changing failed.");
+      return 0;
+    }
+  }
+  clone->data = (float *)malloc((clone->NrBins)*(clone->NrPols)*(clone->NrFreqChan)*(clone->NrSubints)*sizeof(float));
+  if(clone->data == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_hyperslab: Memory allocation error.");
+    return 0;
+  }
+  readaheadPSRData(&original, nskip, nread, verbose);
+  if(chanelnr < 0 && polnr < 0) {
+    if(readSubintsPSRData(&original, nskip, nread, clone->data, verbose) != 1) {
+      fflush(stdout);
+      printerror(verbose.debug, "ERROR preprocess_hyperslab: Error reading subints %ld-%ld.", nskip, nskip+nread-1);
+      return 0;
+    }
+  }
+  for(n = 0; n < nread && (chanelnr >= 0 || polnr >= 0); n++) {
+    if(verbose.verbose && verbose.nocounters == 0) {
+      for(i = 0; i < verbose.indent; i++)
+ printf(" ");
+      printf("  %.1f%%     \r", 100.0*n/(float)nread);
+      fflush(stdout);
+    }
+    for(pc = 0; pc < clone->NrPols; pc++) {
+      p = polnr >= 0 ? polnr : pc;
+      for(fc = 0; fc < clone->NrFreqChan; fc++) {
+ f = chanelnr >= 0 ? chanelnr : fc;
+ if(readPulsePSRData(&original, nskip+n, p, f, 0, clone->NrBins, &(clone->data[clone->NrBins*(pc+clone->NrPols*(fc+n*clone->NrFreqChan))]), verbose) != 1) {
+   fflush(stdout);
+   printerror(verbose.debug, "ERROR preprocess_hyperslab: Error reading pulse.");
+   return 0;
+ }
+      }
+    }
+  }
+  if(verbose.verbose) {
+    for(i = 0; i < verbose.indent; i++)
+      printf(" ");
+    printf("  done            \n");
+  }
+  return 1;
+}
 int preprocess_blocksize(datafile_definition original, datafile_definition *clone, int blocksize, verbose_definition verbose)
 {
   int i;
@@ -1677,10 +2082,11 @@ int preprocess_scale(datafile_definition original, float factor, float offset, v
 }
 int preprocess_dedisperse(datafile_definition *original, int undo, int update, double freq_ref, verbose_definition verbose)
 {
-  long p, f, n;
+  long f, n, nrdelays;
   int i, inffreq, inffreq_old;
   long double dt, dt_samples;
-  double freq;
+  double freq, tsamp;
+  float *delays;
   if(undo && update) {
     printerror(verbose.debug, "ERROR preprocess_dedisperse (%s): Cannot update the reference frequency and re-dedisperse the data simultaneously.", original->filename);
     return 0;
@@ -1810,22 +2216,41 @@ int preprocess_dedisperse(datafile_definition *original, int undo, int update, d
     printerror(verbose.debug, "ERROR preprocess_dedisperse (%s): Cannot handle PA data.", original->filename);
     return 0;
   }
-  for(p = 0; p < original->NrPols; p++) {
+  if(original->freqMode == FREQMODE_FREQTABLE && update == 0)
+    nrdelays = original->NrSubints;
+  else
+    nrdelays = 1;
+  delays = (float *)malloc(nrdelays*original->NrFreqChan*sizeof(float));
+  if(delays == NULL) {
+    fflush(stdout);
+    printerror(verbose.debug, "ERROR preprocess_dedisperse (%s): Memory allocation error.", original->filename);
+    return 0;
+  }
+  tsamp = get_tsamp(*original, 0, verbose);
+  for(n = 0; n < nrdelays; n++) {
     for(f = 0; f < original->NrFreqChan; f++) {
-      for(n = 0; n < original->NrSubints; n++) {
- if(update == 0) {
-   dt = calcDMDelay(get_weighted_channel_freq(*original, n, f, verbose), original->freq_ref, inffreq, original->dm);
-   if(undo)
-     dt *= -1.0;
-   dt /= get_tsamp(*original, 0, verbose);
- }else {
-   dt = dt_samples;
- }
- if(rotateSinglepulse(&(original->data[original->NrBins*(p+original->NrPols*(f+n*original->NrFreqChan))]), original->NrBins, -dt, verbose) == 0)
-   return 0;
+      if(update == 0) {
+ dt = calcDMDelay(get_weighted_channel_freq(*original, n, f, verbose), original->freq_ref, inffreq, original->dm);
+ if(undo)
+   dt *= -1.0;
+ dt /= tsamp;
+      }else {
+ dt = dt_samples;
       }
+      delays[n*original->NrFreqChan+f] = -dt;
+    }
+  }
+  for(n = 0; n < original->NrSubints; n++) {
+    if(nrdelays > 1)
+      f = n*original->NrFreqChan;
+    else
+      f = 0;
+    if(shiftSinglepulseBatch(&(original->data[original->NrBins*original->NrPols*original->NrFreqChan*n]), original->NrBins, original->NrPols*original->NrFreqChan, original->NrPols, &delays[f], verbose) == 0) {
+      free(delays);
+      return 0;
     }
   }
+  free(delays);
   if(undo == 0) {
     original->isDeDisp = 1;
   }else {
@@ -1840,9 +2265,10 @@ int preprocess_dedisperse(datafile_definition *original, int undo, int update, d
 }
 int preprocess_deFaraday(datafile_definition *original, int undo, int update, double freq_ref, double *rm_table, verbose_definition verbose)
 {
-  long f, n, b;
+  long f, n, b, nrangles;
   int i, inffreq, inffreq_old;
-  float dphi, phi, L, *pulseQ, *pulseU;
+  float dphi, Q, cos2psi, sin2psi, *pulseQ, *pulseU, *rottable;
+  double freq, freq_table;
   verbose_definition verbose2;
   if(original->freq_ref < -1.1) {
     printwarning(verbose.debug, "WARNING preprocess_deFaraday (%s): Reference frequency is unknown. The reference frequency is set to infinite frequency.", original->filename);
@@ -1991,7 +2417,6 @@ int preprocess_deFaraday(datafile_definition *original, int undo, int update, do
       printerror(verbose.debug, "ERROR preprocess_deFaraday (%s): Cannot update the reference frequency when the RM is specified speperately for each pulse longitude bin.", original->filename);
       return 0;
     }
-    double freq;
     freq = get_weighted_channel_freq(*original, 0, 0, verbose);
     dphi = -calcRMAngle(freq, freq_ref, inffreq_old, original->rm);
     dphi += calcRMAngle(freq, original->freq_ref, inffreq, original->rm);
@@ -2007,54 +2432,65 @@ int preprocess_deFaraday(datafile_definition *original, int undo, int update, do
       printf("  Rotating Q&U\n");
     }
   }
-  pulseQ = (float *)malloc(original->NrBins*sizeof(float));
-  pulseU = (float *)malloc(original->NrBins*sizeof(float));
-  if(pulseQ == NULL || pulseU == NULL) {
+  if(rm_table != NULL)
+    nrangles = original->NrBins;
+  else if(original->freqMode == FREQMODE_FREQTABLE && update == 0)
+    nrangles = original->NrSubints*original->NrFreqChan;
+  else
+    nrangles = original->NrFreqChan;
+  rottable = (float *)malloc(2*nrangles*sizeof(float));
+  if(rottable == NULL) {
     fflush(stdout);
     printerror(verbose.debug, "ERROR preprocess_deFaraday (%s): Cannot allocate memory.", original->filename);
     return 0;
   }
-  for(f = 0; f < original->NrFreqChan; f++) {
-    for(n = 0; n < original->NrSubints; n++) {
+  if(rm_table == NULL) {
+    for(b = 0; b < nrangles; b++) {
       if(update == 0) {
- if(rm_table == NULL)
-   dphi = calcRMAngle(get_weighted_channel_freq(*original, n, f, verbose), original->freq_ref, inffreq, original->rm);
+ dphi = calcRMAngle(get_weighted_channel_freq(*original, b/original->NrFreqChan, b % original->NrFreqChan, verbose), original->freq_ref, inffreq, original->rm);
  if(undo)
    dphi *= -1.0;
       }
-      if(readPulsePSRData(original, n, 1, f, 0, original->NrBins, pulseQ, verbose) != 1) {
- fflush(stdout);
- printerror(verbose.debug, "ERROR preprocess_deFaraday (%s): Read error.", original->filename);
- return 0;
-      }
-      if(readPulsePSRData(original, n, 2, f, 0, original->NrBins, pulseU, verbose) != 1) {
- fflush(stdout);
- printerror(verbose.debug, "ERROR preprocess_deFaraday (%s): Read error.", original->filename);
- return 0;
-      }
-      for(b = 0; b < original->NrBins; b++) {
- if(rm_table != NULL) {
-   if(update == 0) {
-     dphi = calcRMAngle(get_weighted_channel_freq(*original, n, f, verbose), original->freq_ref, inffreq, rm_table[b]);
-     if(undo)
-       dphi *= -1.0;
+      rottable[2*b] = cos(2.0*dphi);
+      rottable[2*b+1] = sin(2.0*dphi);
+    }
+  }
+  freq_table = -1;
+  for(f = 0; f < original->NrFreqChan; f++) {
+    for(n = 0; n < original->NrSubints; n++) {
+      pulseQ = &(original->data[original->NrBins*(1+original->NrPols*(f+n*original->NrFreqChan))]);
+      pulseU = pulseQ + original->NrBins;
+      if(rm_table != NULL) {
+ freq = get_weighted_channel_freq(*original, n, f, verbose);
+ if(freq != freq_table) {
+   for(b = 0; b < original->NrBins; b++) {
+     if(update == 0) {
+       dphi = calcRMAngle(freq, original->freq_ref, inffreq, rm_table[b]);
+       if(undo)
+  dphi *= -1.0;
+     }
+     rottable[2*b] = cos(2.0*dphi);
+     rottable[2*b+1] = sin(2.0*dphi);
    }
+   freq_table = freq;
+ }
+ for(b = 0; b < original->NrBins; b++) {
+   Q = pulseQ[b];
+   pulseQ[b] = Q*rottable[2*b] + pulseU[b]*rottable[2*b+1];
+   pulseU[b] = pulseU[b]*rottable[2*b] - Q*rottable[2*b+1];
+ }
+      }else {
+ if(nrangles > original->NrFreqChan)
+   b = n*original->NrFreqChan+f;
+ else
+   b = f;
+ cos2psi = rottable[2*b];
+ sin2psi = rottable[2*b+1];
+ for(b = 0; b < original->NrBins; b++) {
+   Q = pulseQ[b];
+   pulseQ[b] = Q*cos2psi + pulseU[b]*sin2psi;
+   pulseU[b] = pulseU[b]*cos2psi - Q*sin2psi;
  }
- L = sqrt(pulseQ[b]*pulseQ[b]+pulseU[b]*pulseU[b]);
- phi = atan2(pulseU[b], pulseQ[b]);
- phi -= 2.0*dphi;
- pulseQ[b] = L*cos(phi);
- pulseU[b] = L*sin(phi);
-      }
-      if(writePulsePSRData(original, n, 1, f, 0, original->NrBins, pulseQ, verbose) != 1) {
- fflush(stdout);
- printerror(verbose.debug, "ERROR preprocess_deFaraday (%s): Write error.", original->filename);
- return 0;
-      }
-      if(writePulsePSRData(original, n, 2, f, 0, original->NrBins, pulseU, verbose) != 1) {
- fflush(stdout);
- printerror(verbose.debug, "ERROR preprocess_deFaraday (%s): Write error.", original->filename);
- return 0;
       }
     }
   }
@@ -2062,8 +2498,7 @@ int preprocess_deFaraday(datafile_definition *original, int undo, int update, do
     original->isDeFarad = 1;
   else
     original->isDeFarad = 0;
-  free(pulseQ);
-  free(pulseU);
+  free(rottable);
   if(verbose.verbose) {
     for(i = 0; i < verbose.indent; i++)
       printf(" ");
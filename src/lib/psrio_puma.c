@@ -17,11 +17,13 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #define _USE_LARGEFILE 1
 #define _LARGEFILE_SOURCE 1
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include <string.h>
 #include <math.h>
 #include "psrsalsa.h"
 #define PUMA_STD 
+#define PuMaBlockSize 4194304
 #ifndef _PUMA_H
 #define _PUMA_H 
 #define MMAX(A,B) (A > B? A: B)
@@ -523,6 +525,21 @@ void PutBEdouble(double *dst, double src)
   ((char*)dst)[6] = ((char*)&src)[1];
   ((char*)dst)[7] = ((char*)&src)[0];
 }
+void swapArrayCopy32(void *src, void *dst, long nelem)
+{
+  long i;
+  unsigned char *sptr = (unsigned char *)src;
+  unsigned char *dptr = (unsigned char *)dst;
+  unsigned char tmp0, tmp1;
+  for(i = 0; i < 4*nelem; i += 4) {
+    tmp0 = sptr[i];
+    tmp1 = sptr[i+1];
+    dptr[i] = sptr[i+3];
+    dptr[i+1] = sptr[i+2];
+    dptr[i+2] = tmp1;
+    dptr[i+3] = tmp0;
+  }
+}
 void swapWord(void *xptr, int size)
 {
   unsigned char *cptr = (unsigned char *)xptr;
@@ -539,6 +556,10 @@ void swapArray(void *xptr, int nelem, int size)
 {
   int i;
   unsigned char *cptr = (unsigned char *)xptr;
+  if(size == 4) {
+    swapArrayCopy32(xptr, xptr, nelem);
+    return;
+  }
   for (i=0; i < nelem; i++)
   {
     swapWord(cptr, size);
@@ -653,7 +674,7 @@ void beheader_convert(Header_type *src, Header_type *dst)
 int prheader(Header_type *inphdr,FILE *srcfile)
 {
   int r;
-#if defined ( __linux__) || defined (__alpha)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
   Header_type behdr;
   r = fread(&behdr,sizeof(Header_type),1,srcfile);
   beheader_convert(&behdr,inphdr);
@@ -673,7 +694,7 @@ int prheader(Header_type *inphdr,FILE *srcfile)
 int pwheader(Header_type *outphdr,FILE *dstfile)
 {
   int r;
-#if defined ( __linux__) || defined (__alpha)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
   Header_type behdr;
   beheader_convert(outphdr,&behdr);
   r = fwrite(&behdr,sizeof(Header_type),1,dstfile);
@@ -700,22 +721,46 @@ int puma_nrpol(Header_type hdr)
 #define ConvertArrayFromBE(xptr,n,size) swapArray(xptr, n, size)
 void pumaread(void *prptr, int size, int nelem,FILE *in)
 {
-#ifdef __alpha
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
   fread(prptr,size,nelem,in);
   ConvertArrayFromBE(prptr,nelem,size);
-#endif
-#ifdef __linux__
+#else
   fread(prptr,size,nelem,in);
-  ConvertArrayFromBE(prptr,nelem,size);
 #endif
-#ifdef __hpux
-  fread(prptr,size,nelem,in);
+}
+void internalPuMaCopyFromBE(float *src, float *dst, long nelem)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  swapArrayCopy32(src, dst, nelem);
+#else
+  memcpy(dst, src, nelem*sizeof(float));
+#endif
+}
+void internalPuMaCopyToBE(float *src, float *dst, long nelem)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  swapArrayCopy32(src, dst, nelem);
+#else
+  memcpy(dst, src, nelem*sizeof(float));
 #endif
 }
 int pumawrite(void *prptr, int size, int nelem,FILE *out)
 {
   int status;
-#ifdef __linux__
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  long i, n;
+  float buffer[1024];
+  if(size == sizeof(float)) {
+    status = 0;
+    for(i = 0; i < nelem; i += 1024) {
+      n = nelem - i;
+      if(n > 1024)
+ n = 1024;
+      internalPuMaCopyToBE((float *)prptr+i, buffer, n);
+      status += fwrite(buffer, size, n, out);
+    }
+    return status;
+  }
   ConvertArrayFromBE(prptr,nelem,size);
   status = fwrite(prptr,size,nelem,out);
   ConvertArrayFromBE(prptr,nelem,size);
@@ -1105,21 +1150,13 @@ void FillPuMaHeader(Header_type *hdr, int obsID, int timefilenr, int freqband, i
 }
 void beadj_convert_write(Adjustments outpadj, FILE *fout)
 {
-#ifdef __linux__
-  Adjustments beadj;
-  PutBEint(&beadj.framenumber, outpadj.framenumber);
-  PutBEfloat(&beadj.scale, outpadj.scale);
-  PutBEfloat(&beadj.offset, outpadj.offset);
-  fwrite(&beadj,sizeof(Adjustments),1,fout);
-#endif
-#ifdef __alpha
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
   Adjustments beadj;
   PutBEint(&beadj.framenumber, outpadj.framenumber);
   PutBEfloat(&beadj.scale, outpadj.scale);
   PutBEfloat(&beadj.offset, outpadj.offset);
   fwrite(&beadj,sizeof(Adjustments),1,fout);
-#endif
-#ifdef __hpux
+#else
   fwrite(&outpadj,sizeof(Adjustments),1,fout);
 #endif
 }
@@ -1348,40 +1385,90 @@ int writePulseWSRTData(datafile_definition datafile, long pulsenr, int polarizat
   pumawrite(pulse, sizeof(float), nrSamples, datafile.fptr);
   return 1;
 }
+long internalPuMaBlockNrSubints(datafile_definition datafile)
+{
+  long nrsubints;
+  nrsubints = PuMaBlockSize/(datafile.NrBins*sizeof(float));
+  if(nrsubints < 1)
+    nrsubints = 1;
+  if(nrsubints > datafile.NrSubints)
+    nrsubints = datafile.NrSubints;
+  return nrsubints;
+}
 int writePuMafile(datafile_definition datafile, float *data, verbose_definition verbose)
 {
-  long n, f, p;
+  long n, f, p, i, nrblock, nrsubints;
+  float *buffer;
+  nrblock = internalPuMaBlockNrSubints(datafile);
+  buffer = malloc(nrblock*datafile.NrBins*sizeof(float));
+  if(buffer == NULL) {
+    printerror(verbose.debug, "ERROR writePuMafile: Memory allocation error.");
+    return 0;
+  }
   fseeko(datafile.fptr, datafile.datastart, SEEK_SET);
   for(p = 0; p < datafile.NrPols; p++) {
     for(f = 0; f < datafile.NrFreqChan; f++) {
-      for(n = 0; n < datafile.NrSubints; n++) {
+      for(n = 0; n < datafile.NrSubints; n += nrblock) {
  if(verbose.verbose && verbose.nocounters == 0) printf("writePuMafile: pulse %ld/%ld\r", n+1, datafile.NrSubints);
- pumawrite(&data[datafile.NrBins*(p+datafile.NrPols*(f+n*datafile.NrFreqChan))], sizeof(float), datafile.NrBins, datafile.fptr);
+ nrsubints = datafile.NrSubints - n;
+ if(nrsubints > nrblock)
+   nrsubints = nrblock;
+ for(i = 0; i < nrsubints; i++)
+   internalPuMaCopyToBE(&data[datafile.NrBins*(p+datafile.NrPols*(f+(n+i)*datafile.NrFreqChan))], &buffer[i*datafile.NrBins], datafile.NrBins);
+ if(fwrite(buffer, sizeof(float), nrsubints*datafile.NrBins, datafile.fptr) != nrsubints*datafile.NrBins) {
+   printerror(verbose.debug, "ERROR writePuMafile: Cannot write data.");
+   free(buffer);
+   return 0;
+ }
       }
     }
   }
+  free(buffer);
   if(verbose.verbose) printf("  Writing is done.              \n");
   return 1;
 }
-int readPuMafile(datafile_definition datafile, float *data, verbose_definition verbose)
+int readPuMasubints(datafile_definition datafile, long firstsubint, long nrread, float *data, verbose_definition verbose)
 {
-  long n, f, p;
+  long n, f, p, i, nrblock, nrsubints;
+  float *buffer;
   if(verbose.verbose) {
     printf("Start reading PuMa file\n");
   }
-  fseeko(datafile.fptr, datafile.datastart, SEEK_SET);
+  nrblock = internalPuMaBlockNrSubints(datafile);
+  if(nrblock > nrread)
+    nrblock = nrread;
+  buffer = malloc(nrblock*datafile.NrBins*sizeof(float));
+  if(buffer == NULL) {
+    printerror(verbose.debug, "ERROR readPuMasubints: Memory allocation error.");
+    return 0;
+  }
   for(p = 0; p < datafile.NrPols; p++) {
     for(f = 0; f < datafile.NrFreqChan; f++) {
-      for(n = 0; n < datafile.NrSubints; n++) {
+      fseeko(datafile.fptr, datafile.datastart+((p*datafile.NrFreqChan+f)*datafile.NrSubints+firstsubint)*datafile.NrBins*sizeof(float), SEEK_SET);
+      for(n = 0; n < nrread; n += nrblock) {
  if(verbose.verbose && verbose.nocounters == 0)
-   printf("  Progress reading PuMa file (%.1f%%)\r", 100.0*(n+(f+p*datafile.NrFreqChan)*datafile.NrSubints)/(float)(datafile.NrSubints*datafile.NrFreqChan*datafile.NrPols));
- pumaread(&data[datafile.NrBins*(p+datafile.NrPols*(f+n*datafile.NrFreqChan))], sizeof(float), datafile.NrBins, datafile.fptr);
+   printf("  Progress reading PuMa file (%.1f%%)\r", 100.0*(n+(f+p*datafile.NrFreqChan)*nrread)/(float)(nrread*datafile.NrFreqChan*datafile.NrPols));
+ nrsubints = nrread - n;
+ if(nrsubints > nrblock)
+   nrsubints = nrblock;
+ if(fread(buffer, sizeof(float), nrsubints*datafile.NrBins, datafile.fptr) != nrsubints*datafile.NrBins) {
+   printerror(verbose.debug, "ERROR readPuMasubints: Cannot read data.");
+   free(buffer);
+   return 0;
+ }
+ for(i = 0; i < nrsubints; i++)
+   internalPuMaCopyFromBE(&buffer[i*datafile.NrBins], &data[datafile.NrBins*(p+datafile.NrPols*(f+(n+i)*datafile.NrFreqChan))], datafile.NrBins);
       }
     }
   }
+  free(buffer);
   if(verbose.verbose) printf("  Reading is done.                           \n");
   return 1;
 }
+int readPuMafile(datafile_definition datafile, float *data, verbose_definition verbose)
+{
+  return readPuMasubints(datafile, 0, datafile.NrSubints, data, verbose);
+}
 int writeHistoryPuma(datafile_definition datafile, verbose_definition verbose)
 {
   Header_type puma_hdr;
@@ -21,6 +21,10 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #include <string.h>
 #include <math.h>
 #include "psrsalsa.h"
+#define SigprocReadBlockSize 4194304
+#define SigprocTransposeTile 32
+int internalSigprocValidNrBits(int nrbits);
+int readSigprocsubints(datafile_definition datafile, long firstsubint, long nrread, float *data, verbose_definition verbose);
 int readSigprocHeader_readParamID(FILE *fin, char **id, verbose_definition verbose)
 {
   int idlength;
@@ -225,8 +229,8 @@ int readSigprocHeader(datafile_definition *datafile, verbose_definition verbose)
  printf("DEBUG: %s=%d\n", id, dummy_int);
       }
       datafile->NrBits = dummy_int;
-      if(datafile->NrBits != 32 && datafile->NrBits != 8) {
- printerror(verbose.debug, "ERROR readSigprocHeader: Can only handle 32-bit or 8-bit data. Got %d bit data.", datafile->NrBits);
+      if(internalSigprocValidNrBits(datafile->NrBits) == 0) {
+ printerror(verbose.debug, "ERROR readSigprocHeader: Can only handle 1, 2, 4, 8, 16 or 32-bit data. Got %d bit data.", datafile->NrBits);
  return 0;
       }
     }else if(strcmp(id, "nifs") == 0) {
@@ -393,131 +397,181 @@ int readSigprocHeader(datafile_definition *datafile, verbose_definition verbose)
     tmp /= subintsize;
     datafile->NrSubints = roundl(tmp);
   }
+  if((datafile->NrFreqChan*datafile->NrBits) % 8 != 0) {
+    printerror(verbose.debug, "ERROR readSigprocHeader: %d bit data with %ld channels does not have time samples aligned at byte boundaries.", datafile->NrBits, datafile->NrFreqChan);
+    return 0;
+  }
   datafile->tsub_list[0] = datafile->NrBins * datafile->fixedtsamp;
   printwarning(verbose.debug, "WARNING readSigprocHeader: Assuming there is only one polarization channel in the data");
   datafile->NrPols = 1;
   return 1;
 }
+int internalSigprocValidNrBits(int nrbits)
+{
+  if(nrbits == 1 || nrbits == 2 || nrbits == 4 || nrbits == 8 || nrbits == 16 || nrbits == 32)
+    return 1;
+  return 0;
+}
+long internalSigprocBlockNrSamples(datafile_definition datafile)
+{
+  long nrsamples;
+  nrsamples = (8*SigprocReadBlockSize)/(datafile.NrFreqChan*datafile.NrBits);
+  if(nrsamples < 1)
+    nrsamples = 1;
+  if(nrsamples > datafile.NrBins)
+    nrsamples = datafile.NrBins;
+  return nrsamples;
+}
+int internalSigprocReadBlock(datafile_definition datafile, long subint, long firstsample, long nrsamples, unsigned char *buffer, verbose_definition verbose)
+{
+  off_t offset;
+  size_t nrbytes;
+  nrbytes = nrsamples*datafile.NrFreqChan*datafile.NrBits/8;
+  offset = (subint*datafile.NrBins+firstsample)*datafile.NrFreqChan*datafile.NrBits/8;
+  offset += (subint+1)*datafile.datastart;
+  fseeko(datafile.fptr, offset, SEEK_SET);
+  if(fread(buffer, 1, nrbytes, datafile.fptr) != nrbytes) {
+    printerror(verbose.debug, "ERROR internalSigprocReadBlock: Cannot read data (sample %ld of subint %ld).", firstsample, subint);
+    return 0;
+  }
+  return 1;
+}
+void internalSigprocDecode(unsigned char *buffer, int nrbits, long first, long stride, long nrsamples, float *samples)
+{
+  long i, j, index;
+  int persample, mask;
+  if(nrbits == 32) {
+    float *buffer_f = (float *)buffer;
+    if(stride == 1) {
+      memcpy(samples, &buffer_f[first], nrsamples*sizeof(float));
+    }else {
+      for(i = 0; i < nrsamples; i++)
+ samples[i] = buffer_f[first+i*stride];
+    }
+  }else if(nrbits == 16) {
+    unsigned short *buffer_s = (unsigned short *)buffer;
+    for(i = 0; i < nrsamples; i++)
+      samples[i] = buffer_s[first+i*stride];
+  }else if(nrbits == 8) {
+    for(i = 0; i < nrsamples; i++)
+      samples[i] = buffer[first+i*stride];
+  }else {
+    persample = 8/nrbits;
+    mask = (1 << nrbits) - 1;
+    if(stride == 1 && first % persample == 0 && nrsamples % persample == 0) {
+      float table[256*8];
+      for(i = 0; i < 256; i++) {
+ for(j = 0; j < persample; j++)
+   table[i*persample+j] = (i >> (j*nrbits)) & mask;
+      }
+      buffer += first/persample;
+      for(i = 0; i < nrsamples/persample; i++) {
+ memcpy(&samples[i*persample], &table[buffer[i]*persample], persample*sizeof(float));
+      }
+    }else {
+      for(i = 0; i < nrsamples; i++) {
+ index = (first+i*stride)*nrbits;
+ samples[i] = (buffer[index >> 3] >> (index & 7)) & mask;
+      }
+    }
+  }
+}
+void internalSigprocTranspose(float *samples, long nrsamples, long nrchans, float *dest, long deststride)
+{
+  long t, f, t2, f2, tmax, fmax;
+  for(f = 0; f < nrchans; f += SigprocTransposeTile) {
+    fmax = f + SigprocTransposeTile;
+    if(fmax > nrchans)
+      fmax = nrchans;
+    for(t = 0; t < nrsamples; t += SigprocTransposeTile) {
+      tmax = t + SigprocTransposeTile;
+      if(tmax > nrsamples)
+ tmax = nrsamples;
+      for(f2 = f; f2 < fmax; f2++) {
+ for(t2 = t; t2 < tmax; t2++) {
+   dest[f2*deststride+t2] = samples[t2*nrchans+f2];
+ }
+      }
+    }
+  }
+}
 int readSigprocfile(datafile_definition datafile, float *data, verbose_definition verbose)
 {
-  long n, f, i, p;
-  float *sample_f;
-  unsigned char *sample_b;
-  int ret;
+  return readSigprocsubints(datafile, 0, datafile.NrSubints, data, verbose);
+}
+int readSigprocsubints(datafile_definition datafile, long firstsubint, long nrread, float *data, verbose_definition verbose)
+{
+  long n, i, nrblock, nrsamples;
+  float *samples;
+  unsigned char *buffer;
   if(datafile.NrPols > 1) {
-    printerror(verbose.debug, "readSigprocfile: Data should have just one polarization");
+    printerror(verbose.debug, "readSigprocsubints: Data should have just one polarization");
     return 0;
   }
-  if(datafile.NrBits != 32 && datafile.NrBits != 8) {
-    printerror(verbose.debug, "ERROR readSigprocfile: Can only handle 32-bit or 8-bit data. Got %d bit data.", datafile.NrBits);
+  if(internalSigprocValidNrBits(datafile.NrBits) == 0) {
+    printerror(verbose.debug, "ERROR readSigprocsubints: Can only handle 1, 2, 4, 8, 16 or 32-bit data. Got %d bit data.", datafile.NrBits);
     return 0;
   }
-  if(datafile.NrBits == 32) {
-    sample_f = malloc(datafile.NrFreqChan*sizeof(float));
-    if(sample_f == NULL) {
-      printerror(verbose.debug, "readSigprocfile: Memory allocation error");
-      return 0;
-    }
-  }else if(datafile.NrBits == 8) {
-    sample_b = malloc(datafile.NrFreqChan);
-    if(sample_b == NULL) {
-      printerror(verbose.debug, "readSigprocfile: Memory allocation error");
-      return 0;
-    }
+  nrblock = internalSigprocBlockNrSamples(datafile);
+  samples = malloc(nrblock*datafile.NrFreqChan*sizeof(float));
+  buffer = malloc(nrblock*datafile.NrFreqChan*datafile.NrBits/8);
+  if(samples == NULL || buffer == NULL) {
+    printerror(verbose.debug, "readSigprocsubints: Memory allocation error");
+    free(samples);
+    free(buffer);
+    return 0;
   }
-  for(n = 0; n < datafile.NrSubints; n++) {
-    for(i = 0; i < datafile.NrBins; i++) {
-      if(datafile.NrBits == 32) {
- ret = fread(sample_f, sizeof(float), datafile.NrFreqChan, datafile.fptr);
-      }else if(datafile.NrBits == 8) {
- ret = fread(sample_b, 1, datafile.NrFreqChan, datafile.fptr);
-      }
-      if(ret != datafile.NrFreqChan) {
- printerror(verbose.debug, "ERROR readSigprocfile: Cannot read data (sample %ld of subint %ld).", i, n);
+  for(n = 0; n < nrread; n++) {
+    for(i = 0; i < datafile.NrBins; i += nrblock) {
+      nrsamples = nrblock;
+      if(i + nrsamples > datafile.NrBins)
+ nrsamples = datafile.NrBins - i;
+      if(internalSigprocReadBlock(datafile, firstsubint+n, i, nrsamples, buffer, verbose) == 0) {
+ free(samples);
+ free(buffer);
  return 0;
       }
-      p = 0;
-      for(f = 0; f < datafile.NrFreqChan; f++) {
- if(datafile.NrBits == 32) {
-   data[datafile.NrBins*(p+datafile.NrPols*(f+n*datafile.NrFreqChan))+i] = sample_f[f];
- }else if(datafile.NrBits == 8) {
-   data[datafile.NrBins*(p+datafile.NrPols*(f+n*datafile.NrFreqChan))+i] = sample_b[f];
- }
-      }
-    }
-    if(n != datafile.NrSubints - 1) {
-      fseeko(datafile.fptr, datafile.datastart, SEEK_CUR);
+      internalSigprocDecode(buffer, datafile.NrBits, 0, 1, nrsamples*datafile.NrFreqChan, samples);
+      internalSigprocTranspose(samples, nrsamples, datafile.NrFreqChan, &data[datafile.NrBins*datafile.NrFreqChan*n+i], datafile.NrBins);
     }
   }
-  if(datafile.NrBits == 32) {
-    free(sample_f);
-  }else if(datafile.NrBits == 8) {
-    free(sample_b);
-  }
+  free(samples);
+  free(buffer);
   if(verbose.verbose) printf("Reading is done.                           \n");
   return 1;
 }
 int readPulseSigprocData(datafile_definition datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose)
 {
-  long i;
-  float *sample_f;
-  unsigned char *sample_b;
-  int ret;
-  off_t offset;
+  long i, nrblock, nrsamples;
+  unsigned char *buffer;
   if(datafile.NrPols > 1) {
     printerror(verbose.debug, "readPulseSigprocData: Data should have just one polarization");
     return 0;
   }
-  if(datafile.NrBits != 32 && datafile.NrBits != 8) {
-    printerror(verbose.debug, "ERROR readPulseSigprocData: Can only handle 32-bit or 8-bit data. Got %d bit data.", datafile.NrBits);
+  if(internalSigprocValidNrBits(datafile.NrBits) == 0) {
+    printerror(verbose.debug, "ERROR readPulseSigprocData: Can only handle 1, 2, 4, 8, 16 or 32-bit data. Got %d bit data.", datafile.NrBits);
     return 0;
   }
-  if(datafile.NrBits == 32) {
-    sample_f = malloc(datafile.NrFreqChan*sizeof(float));
-    if(sample_f == NULL) {
-      printerror(verbose.debug, "readPulseSigprocData: Memory allocation error");
-      return 0;
-    }
-  }else if(datafile.NrBits == 8) {
-    sample_b = malloc(datafile.NrFreqChan);
-    if(sample_b == NULL) {
-      printerror(verbose.debug, "readPulseSigprocData: Memory allocation error");
-      return 0;
-    }
-  }
-  offset = (pulsenr*datafile.NrBins+binnr)*datafile.NrFreqChan+freq;
-  if(datafile.NrBits == 32) {
-    offset *= 4;
+  nrblock = internalSigprocBlockNrSamples(datafile);
+  if(nrblock > nrSamples)
+    nrblock = nrSamples;
+  buffer = malloc(nrblock*datafile.NrFreqChan*datafile.NrBits/8);
+  if(buffer == NULL) {
+    printerror(verbose.debug, "readPulseSigprocData: Memory allocation error");
+    return 0;
   }
-  offset += (pulsenr+1)*datafile.datastart;
-  fseeko(datafile.fptr, offset, SEEK_SET);
-  for(i = 0; i < nrSamples; i++) {
-    if(datafile.NrBits == 32) {
-      ret = fread(sample_f, sizeof(float), 1, datafile.fptr);
-      pulse[i] = *sample_f;
-    }else if(datafile.NrBits == 8) {
-      ret = fread(sample_b, 1, 1, datafile.fptr);
-      pulse[i] = *sample_b;
-    }
-    if(ret != 1) {
+  for(i = 0; i < nrSamples; i += nrblock) {
+    nrsamples = nrblock;
+    if(i + nrsamples > nrSamples)
+      nrsamples = nrSamples - i;
+    if(internalSigprocReadBlock(datafile, pulsenr, binnr+i, nrsamples, buffer, verbose) == 0) {
       printerror(verbose.debug, "ERROR readPulseSigprocData: Cannot read data.");
+      free(buffer);
       return 0;
     }
-    if(datafile.NrFreqChan > 1) {
-      if(i < nrSamples-1) {
- if(datafile.NrBits == 32) {
-   fseeko(datafile.fptr, (datafile.NrFreqChan-1)*sizeof(float), SEEK_CUR);
- }else {
-   fseeko(datafile.fptr, (datafile.NrFreqChan-1), SEEK_CUR);
- }
-      }
-    }
-  }
-  if(datafile.NrBits == 32) {
-    free(sample_f);
-  }else if(datafile.NrBits == 8) {
-    free(sample_b);
+    internalSigprocDecode(buffer, datafile.NrBits, freq, datafile.NrFreqChan, nrsamples, &pulse[i]);
   }
+  free(buffer);
   return 1;
 }
 int readSigprocASCIIHeader(datafile_definition *datafile, verbose_definition verbose)
@@ -17,6 +17,7 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #include <psrsalsa_defines.h>
 #include <psrsalsa_typedefs.h>
 int isValidPSRDATA_format(int format);
+int isRandomAccessPSRDATA_format(int format);
 void printPSRDataFormats(FILE *printdevice, int nrspaces);
 int parsePSRDataFormats(char *cmd);
 void cleanPSRData(datafile_definition *datafile, verbose_definition verbose);
@@ -32,11 +33,17 @@ int set_projectID_PSRData(datafile_definition *datafile_dest, char *projectID, v
 int guessPSRData_format(char *filename, int noerror, verbose_definition verbose);
 int openPSRData(datafile_definition *datafile, char *filename, int format, int enable_write, int read_in_memory, int nowarnings, verbose_definition verbose);
 int closePSRData(datafile_definition *datafile, int perserve_header_info, verbose_definition verbose);
+void free_data_PSRData(datafile_definition *datafile, verbose_definition verbose);
 void printHeaderPSRData(datafile_definition datafile, int update, verbose_definition verbose);
 int readHeaderPSRData(datafile_definition *datafile, int readnoscales, int nowarnings, verbose_definition verbose);
 int writeHeaderPSRData(datafile_definition *datafile, int argc, char **argv, int cmdOnly, verbose_definition verbose);
 int get_pointer_PulsePSRData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, float **pulse_ptr, verbose_definition verbose);
 int readPulsePSRData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose);
+int enableSubintCachePSRData(datafile_definition *datafile, long maxbytes, verbose_definition verbose);
+void freeSubintCachePSRData(datafile_definition *datafile, verbose_definition verbose);
+int readaheadPSRData(datafile_definition *datafile, long firstsubint, long nrsubints, verbose_definition verbose);
+int readSubintPSRData(datafile_definition *datafile, long subintnr, float *subint, verbose_definition verbose);
+int readSubintsPSRData(datafile_definition *datafile, long firstsubint, long nrsubints, float *data, verbose_definition verbose);
 int writePulsePSRData(datafile_definition *datafile, long pulsenr, int polarization, int freq, int binnr, long nrSamples, float *pulse, verbose_definition verbose);
 int readPSRData(datafile_definition *datafile, float *data, verbose_definition verbose);
 int writePSRData(datafile_definition *datafile, float *data, verbose_definition verbose);
@@ -75,6 +82,8 @@ double get_nonweighted_channel_freq(datafile_definition psrdata, long channel, v
 double get_weighted_channel_freq(datafile_definition psrdata, long subint, long channel, verbose_definition verbose);
 int set_weighted_channel_freq(datafile_definition *psrdata, long subint, long channel, double freq, verbose_definition verbose);
 int rebinPulse(float *Ipulse, long NrBins, float *Ipulse2, long NrBins2, int noDependencyWarning, verbose_definition verbose);
+void convertFloatToHalf(float *src, unsigned short *dst, long nelem, int halftype);
+void convertHalfToFloat(unsigned short *src, float *dst, long nelem, int halftype);
 int continuous_shift(datafile_definition fin, datafile_definition *fout, int shift, int circularShift, char *output_name, int oformat, int argc, char **argv, verbose_definition verbose, int verbose2);
 int data_parang(datafile_definition data, long subintnr, double *parang, verbose_definition verbose);
 int check_baseline_subtracted(datafile_definition data, verbose_definition verbose);
@@ -88,6 +97,11 @@ void print_fitsio_version_used(FILE *stream);
 void psrfits_set_noweights(int val);
 void psrfits_set_absweights(int val);
 void psrfits_set_use_weighted_freq(int val);
+void psrsalsabinary_set_compression(int val);
+void psrsalsabinary_set_tiles(long nrsubints, long nrchans);
+void headercache_set_directory(char *directory);
+int readHeaderCachePSRData(datafile_definition *datafile, verbose_definition verbose);
+int writeHeaderCachePSRData(datafile_definition *datafile, verbose_definition verbose);
 int filterPApoints(datafile_definition *datafile, verbose_definition verbose);
 int readPPOLfile(datafile_definition *datafile, float *data, int extended, float add_longitude_shift, verbose_definition verbose);
 int writePPOLfile(datafile_definition datafile, float *data, int extended, int onlysignificantPA, int twoprofiles, float PAoffset, verbose_definition verbose);
@@ -104,12 +118,15 @@ int preprocess_deFaraday(datafile_definition *original, int undo, int update, do
 int preprocess_changeRefFreq(datafile_definition *original, double freq_ref_new, verbose_definition verbose);
 int preprocess_addsuccessiveFreqChans(datafile_definition original, datafile_definition *clone, long nrfreq, int *fzapMask, verbose_definition verbose);
 int preprocess_rebin(datafile_definition original, datafile_definition *clone, long NrBins, verbose_definition verbose);
+int preprocess_scrunch(datafile_definition original, datafile_definition *clone, long nrfreq, long nrpulses, int complete, int *fzapMask, long NrBins, verbose_definition verbose);
 int preprocess_debase(datafile_definition *original, pulselongitude_regions_definition *onpulse, float **baseline, int remove_shape, verbose_definition verbose);
 int preprocess_channelselect(datafile_definition original, datafile_definition *clone, long chanelnr, verbose_definition verbose);
 int preprocess_pulsesselect(datafile_definition original, datafile_definition *clone, long nskip, long nread, verbose_definition verbose);
+int preprocess_select_inplace(datafile_definition *original, long nskip, long nread, long chanelnr, long polnr, verbose_definition verbose);
 int preprocess_blocksize(datafile_definition original, datafile_definition *clone, int blocksize, verbose_definition verbose);
 int preprocess_fftshift(datafile_definition original, long singlesubint, float shiftPhase, int addslope, float slope, verbose_definition verbose);
 int preprocess_polselect(datafile_definition original, datafile_definition *clone, long polnr, verbose_definition verbose);
+int preprocess_hyperslab(datafile_definition original, datafile_definition *clone, long nskip, long nread, long chanelnr, long polnr, verbose_definition verbose);
 int preprocess_transposeRawFBdata(datafile_definition original, datafile_definition *clone, verbose_definition verbose);
 int preprocess_norm(datafile_definition original, float normvalue, pulselongitude_regions_definition *onpulse, int global, verbose_definition verbose);
 int preprocess_clip(datafile_definition original, float clipvalue, verbose_definition verbose);
@@ -119,7 +136,18 @@ int preprocess_removenan(datafile_definition original, verbose_definition verbos
 int preprocess_checkinf(datafile_definition original, int generate_warning, verbose_definition verbose);
 int preprocess_corrParAng(datafile_definition *original, datafile_definition *clone, int undo, verbose_definition verbose);
 void print_fftw_version_used(FILE *stream);
+void fftplan_set_wisdom(char *filename, int planlevel, verbose_definition verbose);
+int fftplan_execute_r2c(int nx, int ny, float *in, float *out, verbose_definition verbose);
+int fftplan_execute_c2r(int nx, int ny, float *in, float *out, verbose_definition verbose);
+int fftplan_execute_many_r2c(int npts, int howmany, float *in, float *out, verbose_definition verbose);
+int fftplan_execute_many_c2r(int npts, int howmany, float *in, float *out, verbose_definition verbose);
+float *fftplan_scratch(long nrfloats, int slot, verbose_definition verbose);
+void fftplan_cleanup(verbose_definition verbose);
+void rotate_set_shiftkernel(int kernel);
+int shiftSinglepulse(float *data, int npts, float epsilon, verbose_definition verbose);
 int rotateSinglepulse(float *data, int npts, float epsilon, verbose_definition verbose);
+int rotateSinglepulseBatch(float *data, int npts, int nrprofiles, int nrpershift, float *epsilon, verbose_definition verbose);
+int shiftSinglepulseBatch(float *data, int npts, int nrprofiles, int nrpershift, float *epsilon, verbose_definition verbose);
 int crosscorrelation_fft(float *data1, float *data2, int ndata, float *cc, verbose_definition verbose);
 int crosscorrelation_fft_padding_cclength(int ndata, int extrazeropad);
 int crosscorrelation_fft_padding(float *data1, float *data2, int ndata, int extrazeropad, float **cc, int *cclength, verbose_definition verbose);
@@ -261,6 +289,8 @@ int processCommandLine(psrsalsaApplication *application, int argc, char **argv,
 void printCitationInfo();
 int parse_command_string(verbose_definition verbose, int argc, char **argv, int argv_index, int check_only, int minrequestedparameters, char *format, ...);
 int preprocessApplication(psrsalsaApplication *application, datafile_definition *psrdata);
+int preprocessApplication_streamable(psrsalsaApplication *application, datafile_definition psrdata, long *blocksubints, verbose_definition verbose);
+int preprocessApplication_block(psrsalsaApplication *application, datafile_definition psrdata, long firstsubint, long nrsubints, datafile_definition *block);
 int applicationAddFilename(int argi, verbose_definition verbose);
 int applicationFilenameList_checkConsecutive(char **argv, verbose_definition verbose);
 int numberInApplicationFilenameList(psrsalsaApplication *application, char **argv, verbose_definition verbose);
@@ -280,6 +310,7 @@ int ascii_file_get_next_line(FILE *fin, char *txt, int maxlinelength, int skipCh
 int ascii_file_stats(FILE *fin, char skipChar, long *nrlines, int maxlinelength, int autoNrColumns, int *nrColumns, verbose_definition verbose);
 int change_filename_extension(char *inputname, char *outputname, char *extension, int outputnamelength, verbose_definition verbose);
 int read_ascii_column(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, double scale, int read_log, float **data, float *mindata, float *maxdata, float *avdata, verbose_definition verbose, int verbose_stderr);
+int read_ascii_columns_double(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int nrcolnums, int *colnums, double scale, int read_log, double **data, double *mindata, double *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr);
 int read_ascii_column_double(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, double scale, int read_log, double **data, double *mindata, double *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr);
 int read_ascii_column_int(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, int **data, int *mindata, int *maxdata, double *avdata, verbose_definition verbose, int verbose_stderr);
 int read_ascii_column_str(char *fname, int skiplines, char skipChar, int nrColumns, int autoNrColumns, long *nrdatapoints, int colnum, char ***data, verbose_definition verbose, int verbose_stderr);
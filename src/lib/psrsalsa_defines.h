@@ -20,6 +20,14 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #define MaxFilenameLength 10000
 #define MaxPgplotDeviceLength 2000
 #define MaxStringLength 10000
+#define PreprocessStreamingBlockMemory 268435456
+#define ReadAheadSubints 64
+#define FFTPlanCacheSize 32
+#define FFTScratchSlots 4
+#define PhaseRampAnchor 256
+#define SHIFTKERNEL_FOURIER 0
+#define SHIFTKERNEL_LINEAR 1
+#define SHIFTKERNEL_INTEGER 2
 #define MaxNrfitReceiverModelFitParameters 11
 #define PUMA_format 1
 #define PSRCHIVE_ASCII_format 5
@@ -86,6 +94,8 @@ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
 #define TSUBMODE_UNKNOWN -1
 #define TSUBMODE_FIXEDTSUB 1
 #define TSUBMODE_TSUBLIST 2
+#define HALFTYPE_BFLOAT16 1
+#define HALFTYPE_FLOAT16 2
 #define POLTYPE_UNKNOWN -1
 #define POLTYPE_STOKES 1
 #define POLTYPE_COHERENCY 2
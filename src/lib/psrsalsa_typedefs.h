@@ -81,15 +81,61 @@ typedef struct {
   char *hostname;
   void *nextEntry;
 }datafile_history_entry_definition;
+typedef struct {
+  int colnum_data;
+  int weightmode;
+  float *weightfactors;
+  double *datfreq;
+  void *rowbuffer;
+  long rowbuffer_size;
+  unsigned char *resident;
+  long resident_rowsize;
+}psrfits_readcontext_definition;
+typedef struct {
+  long nrlines;
+  long *recordpos;
+  float *scale;
+  float *offset;
+  char *buffer;
+  long buffer_size;
+}epn_readcontext_definition;
+typedef struct {
+  long long *chunkpos;
+  long long *chunklen;
+  long tilesubints, tilechans, nrtilechans, nrtiles, tilesize;
+  long *chunknr;
+  float *chunk;
+  float *row;
+  long writerow;
+  long long filepos;
+  unsigned char *shuffled;
+  unsigned char *buffer;
+  long buffer_size;
+}psrsalsa_readcontext_definition;
+typedef struct {
+  long nrslots, nrsubints;
+  long *subintnr;
+  long *slotnr;
+  unsigned long *lastuse;
+  float *data;
+  unsigned long clock;
+  long hits, misses;
+}subint_cache_definition;
 typedef struct
 {
   FILE *fptr, *fptr_hdr;
   fitsfile *fits_fptr;
+  psrfits_readcontext_definition *fits_readcontext;
+  epn_readcontext_definition *epn_readcontext;
+  psrsalsa_readcontext_definition *psrsalsa_readcontext;
+  subint_cache_definition *subint_cache;
   char *filename;
   int format;
   int version;
   int opened_flag, enable_write_flag;
   int dumpOnClose;
+  int deferredRead;
+  long readahead_last, readahead_next;
   char *psrname;
   char *observatory;
   char *instrument;
@@ -127,6 +173,10 @@ typedef struct
   char xrangeset, yrangeset;
   datafile_history_entry_definition history;
   float *data;
+  void *data_mmap;
+  size_t data_mmap_size;
+  unsigned short *data_half;
+  int halfType;
   float *offpulse_rms;
   float *scales, *offsets, *weights;
   int weight_stats_set;
@@ -193,6 +243,12 @@ typedef struct {
   int switch_cmaplist;
   int switch_insertparang, switch_deparang, do_parang_corr;
   int switch_history_cmd_only, history_cmd_only;
+  int switch_headercache;
+  int switch_packed, read_in_memory;
+  int switch_halfprec;
+  int switch_subintcache; long subintcache;
+  int switch_wisdom;
+  int switch_shiftkernel;
   int switch_norm, do_norm; float normvalue;
   int switch_normglobal, do_normglobal;
   int switch_clip, do_clip; float clipvalue;
@@ -33,7 +33,6 @@ int calc2DFS(float *data, long nry, long nrx, unsigned long fft_size, float *two
   #ifdef USEFFTW3
     float *inputdata, pwr;
     fftwf_complex *fftdata;
-    fftwf_plan plan;
   #else
     float ***inputdata, **speq;
   #endif
@@ -102,7 +101,6 @@ int calc2DFS(float *data, long nry, long nrx, unsigned long fft_size, float *two
       printerror(verbose.debug, "ERROR calc2DFS: fftwf_malloc failed.");
       return 0;
     }
-    plan = fftwf_plan_dft_r2c_2d(nrx2, fft_size, inputdata, fftdata, FFTW_ESTIMATE);
   #else
     inputdata = f3tensor(1,1,1,nrx2,1,fft_size);
     speq = matrix(1,1,1,2*nrx2);
@@ -151,7 +149,11 @@ int calc2DFS(float *data, long nry, long nrx, unsigned long fft_size, float *two
       }
     }
 #ifdef USEFFTW3
-    fftwf_execute(plan);
+    if(fftplan_execute_r2c(nrx2, fft_size, inputdata, (float *)fftdata, verbose) == 0) {
+      fftwf_free(fftdata);
+      free(inputdata);
+      return 0;
+    }
     for(nb = 0; nb < nrx2; nb++) {
       nb2 = nb+nrx2/2;
       if(nb2 >= nrx2)
@@ -187,7 +189,11 @@ int calc2DFS(float *data, long nry, long nrx, unsigned long fft_size, float *two
  }
       }
 #ifdef USEFFTW3
-    fftwf_execute(plan);
+    if(fftplan_execute_r2c(nrx2, fft_size, inputdata, (float *)fftdata, verbose) == 0) {
+      fftwf_free(fftdata);
+      free(inputdata);
+      return 0;
+    }
     for(nb = 0; nb < nrx2; nb++) {
       nb2 = nb+nrx2/2;
       if(nb2 >= nrx2)
@@ -220,7 +226,6 @@ int calc2DFS(float *data, long nry, long nrx, unsigned long fft_size, float *two
   if(nr_fftblocks > 1 && verbose.nocounters == 0)
     printf("Done                       \n");
 #ifdef USEFFTW3
-  fftwf_destroy_plan(plan);
   fftwf_free(fftdata);
   free(inputdata);
 #else
@@ -240,10 +245,6 @@ int calcLRFS(float *data, long nry, long nrx, unsigned long fft_size, float *lrf
   int k;
   float *phase_track_complex_template, *phase_track_complex;
   long ok, itteration, nrphasetracks, nspecbins;
-#ifdef USEFFTW3
-  fftwf_plan plan1;
-  fftwf_plan plan2;
-#endif
   if(regions != NULL) {
     *var_rms = 0;
     var_mean = 0;
@@ -268,8 +269,6 @@ int calcLRFS(float *data, long nry, long nrx, unsigned long fft_size, float *lrf
     return 0;
   }
 #ifdef USEFFTW3
-  plan1 = fftwf_plan_dft_r2c_1d(fft_size, data1, (fftwf_complex *)data1, FFTW_ESTIMATE);
-  plan2 = fftwf_plan_dft_c2r_1d(fft_size, (fftwf_complex *)data1, data1, FFTW_ESTIMATE);
   if(fft_size > 2147483640) {
     fflush(stdout);
     printerror(verbose.debug, "ERROR calcLRFS: requested fft too long.");
@@ -322,7 +321,15 @@ int calcLRFS(float *data, long nry, long nrx, unsigned long fft_size, float *lrf
  pwrtot += data1[pulsenr];
       }
 #ifdef USEFFTW3
-      fftwf_execute(plan1);
+      if(fftplan_execute_r2c(1, fft_size, data1, data1, verbose) == 0) {
+ free(data1);
+ free(lrfs_tmp);
+ if(calcPhaseTrack || calcsubpulseAmplitude) {
+   free(phase_track_complex);
+   free(phase_track_complex_template);
+ }
+ return 0;
+      }
 #else
       realft(data1-1, fft_size, 1);
       data1[2*(fft_size/2)] = data1[1];
@@ -537,10 +544,6 @@ int calcLRFS(float *data, long nry, long nrx, unsigned long fft_size, float *lrf
     free(phase_track_complex);
     free(phase_track_complex_template);
   }
-#ifdef USEFFTW3
-  fftwf_destroy_plan(plan1);
-  fftwf_destroy_plan(plan2);
-#endif
   return 1;
 }
 void calcModindex(float *lrfs, float *profile, long nrx, unsigned long fft_size, unsigned long nrpulses, float *sigma, float *rms_sigma, float *modind, float *rms_modind, pulselongitude_regions_definition *regions, float var_rms, float *avrg_offpulse_lrfs_power, verbose_definition verbose)
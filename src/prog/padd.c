@@ -40,8 +40,10 @@ int main(int argc, char **argv)
   initApplication(&application, "padd", "[options] inputfiles");
   application.switch_blocksize = 1;
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
   application.switch_debug = 1;
   application.switch_filelist = 1;
+  application.switch_headercache = 1;
   application.switch_iformat = 1;
   application.switch_oformat = 1;
   application.switch_formatlist = 1;
@@ -173,7 +175,7 @@ int main(int argc, char **argv)
     if(memsave == 0 || (currentfilenumber == 0 && noinput == 0)) {
       if(currentfilenumber == 0)
  printf("Read in input files:\n");
-      if(openPSRData(fin[currentfilenumber], inputname, application.iformat, 0, 1, 0, verbose2) == 0) {
+      if(openPSRData(fin[currentfilenumber], inputname, application.iformat, 0, 2, 0, verbose2) == 0) {
  printerror(application.verbose_state.debug, "ERROR padd: Cannot open %s\n", inputname);
  return 0;
       }
@@ -364,7 +366,7 @@ int main(int argc, char **argv)
     currentfilenumber_index = sort_indx[currentfilenumber];
     if(memsave) {
       closePSRData(fin[currentfilenumber_index], 0, application.verbose_state);
-      if(openPSRData(fin[currentfilenumber_index], inputname, application.iformat, 0, 1, 0, application.verbose_state) == 0) {
+      if(openPSRData(fin[currentfilenumber_index], inputname, application.iformat, 0, 2, 0, application.verbose_state) == 0) {
  printerror(application.verbose_state.debug, "ERROR padd: Cannot open %s\n", inputname);
  return 0;
       }
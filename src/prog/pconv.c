@@ -24,8 +24,9 @@ void print_help();
 int main(int argc, char **argv)
 {
   datafile_definition fin, fout;
-  int read_wholefile, indx;
-  long i, n, p, f, n1, n2;
+  int read_wholefile, stream_blocks, indx;
+  long i, n, p, f, n1, n2, blocksubints, nout;
+  datafile_definition block;
   float *pulseData, sample;
   char outputname[MaxFilenameLength], *dummy_ptr;
   psrsalsaApplication application;
@@ -40,6 +41,8 @@ int main(int argc, char **argv)
   application.switch_rot = 1;
   application.switch_rotdeg = 1;
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_formatlist = 1;
   application.switch_tscr = 1;
@@ -115,13 +118,20 @@ int main(int argc, char **argv)
     }
   if(!openPSRData(&fin, dummy_ptr, application.iformat, 0, read_wholefile, 0, application.verbose_state))
     return 0;
+  stream_blocks = 0;
   if(read_wholefile == 0) {
-    if(application.fchan_select != -1) {
+    if(!readHeaderPSRData(&fin, 0, 0, application.verbose_state))
+      return 0;
+    if(!(application.iformat == SIGPROC_format && application.oformat == PUMA_format) && !(application.iformat == PSRCHIVE_ASCII_format && application.oformat == PUMA_format) && fin.tsubMode == TSUBMODE_FIXEDTSUB) {
+      if(preprocessApplication_streamable(&application, fin, &blocksubints, application.verbose_state) == 0) {
+ printerror(application.verbose_state.debug, "ERROR pconv: Requested preprocessing cannot be combined with the -memsave option.");
+ return 0;
+      }
+      stream_blocks = 1;
+    }else if(application.fchan_select != -1) {
       printerror(application.verbose_state.debug, "ERROR pconv: -fchan option doesn't work with -memsave option.");
       return 0;
     }
-    if(!readHeaderPSRData(&fin, 0, 0, application.verbose_state))
-      return 0;
   }
   if(PSRDataHeader_parse_commandline(&fin, argc, argv, application.verbose_state) == 0)
     return 0;
@@ -137,7 +147,37 @@ int main(int argc, char **argv)
       return 0;
     }
   }
-  copy_params_PSRData(fin, &fout, application.verbose_state);
+  n1 = application.nskip;
+  if(application.nread > 0)
+    n2 = application.nskip + application.nread;
+  else
+    n2 = fin.NrSubints;
+  if(stream_blocks) {
+    if(n2 > fin.NrSubints)
+      n2 = fin.NrSubints;
+    if(application.dotscr > 0 && application.tscr_complete)
+      n2 = n1 + ((n2-n1)/application.dotscr)*application.dotscr;
+    if(n2 <= n1) {
+      printerror(application.verbose_state.debug, "ERROR pconv: No subints left to process.");
+      return 0;
+    }
+    if(preprocessApplication_block(&application, fin, n1, n2-n1 < blocksubints ? n2-n1 : blocksubints, &block) == 0)
+      return 0;
+    copy_params_PSRData(block, &fout, application.verbose_state);
+    if(application.dotscr > 0)
+      fout.NrSubints = (n2-n1+application.dotscr-1)/application.dotscr;
+    else if(application.dotscr < 0)
+      fout.NrSubints = (n2-n1)*(-application.dotscr);
+    else
+      fout.NrSubints = n2-n1;
+    if(fout.tsubMode == TSUBMODE_TSUBLIST)
+      fout.tsubMode = TSUBMODE_FIXEDTSUB;
+    if(fout.gentype == GENTYPE_PROFILE && fout.NrSubints > 1)
+      fout.gentype = GENTYPE_SUBINTEGRATIONS;
+  }else {
+    copy_params_PSRData(fin, &fout, application.verbose_state);
+    fout.NrSubints = n2 - n1;
+  }
   double period;
   int ret;
   if(fin.isFolded) {
@@ -158,12 +198,6 @@ int main(int argc, char **argv)
     printerror(application.verbose_state.debug, "ERROR pconv: Changing filename failed");
     return 0;
   }
-  n1 = application.nskip;
-  if(application.nread > 0)
-    n2 = application.nskip + application.nread;
-  else
-    n2 = fin.NrSubints;
-  fout.NrSubints = n2 - n1;
   if(!openPSRData(&fout, outputname, application.oformat, 1, 0, 0, application.verbose_state))
     return 0;
   if(!writeHeaderPSRData(&fout, argc, argv, application.history_cmd_only, application.verbose_state))
@@ -264,8 +298,32 @@ int main(int argc, char **argv)
    }
  }
       }
+    }else if(stream_blocks) {
+      nout = 0;
+      for(n = n1; n < n2; n += blocksubints) {
+ if(application.verbose_state.verbose) {
+   printf("pulse %ld/%ld\r", n+1-n1, n2-n1);
+   fflush(stdout);
+ }
+ if(n != n1) {
+   if(preprocessApplication_block(&application, fin, n, n2-n < blocksubints ? n2-n : blocksubints, &block) == 0)
+     return 0;
+ }
+ for(i = 0; i < block.NrSubints; i++) {
+   for(p = 0; p < block.NrPols; p++) {
+     for(f = 0; f < block.NrFreqChan; f++) {
+       if(writePulsePSRData(&fout, nout+i, p, f, 0, block.NrBins, &block.data[block.NrBins*(p+block.NrPols*(f+i*block.NrFreqChan))], application.verbose_state) == 0) {
+  printerror(application.verbose_state.debug, "ERROR pconv: Cannot write individual pulses.");
+  return 0;
+       }
+     }
+   }
+ }
+ nout += block.NrSubints;
+ closePSRData(&block, 0, application.verbose_state);
+      }
     }else {
-      pulseData = (float *)malloc(fin.NrBins*sizeof(float));
+      pulseData = (float *)malloc(fin.NrBins*fin.NrPols*fin.NrFreqChan*sizeof(float));
       if(pulseData == NULL) {
  printerror(application.verbose_state.debug, "ERROR pconv: Cannot allocate memory.");
  return 0;
@@ -275,13 +333,13 @@ int main(int argc, char **argv)
    printf("pulse %ld/%ld\r", n+1-n1, fout.NrSubints);
    fflush(stdout);
  }
+ if(readSubintPSRData(&fin, n, pulseData, application.verbose_state) == 0) {
+   printerror(application.verbose_state.debug, "ERROR pconv: Cannot read individual pulses from data.");
+   return 0;
+ }
  for(p = 0; p < fin.NrPols; p++) {
    for(f = 0; f < fin.NrFreqChan; f++) {
-     if(readPulsePSRData(&fin, n, p, f, 0, fin.NrBins, pulseData, application.verbose_state) == 0) {
-       printerror(application.verbose_state.debug, "ERROR pconv: Cannot read individual pulses from data.");
-       return 0;
-     }
-     if(writePulsePSRData(&fout, n-n1, p, f, 0, fin.NrBins, pulseData, application.verbose_state) == 0) {
+     if(writePulsePSRData(&fout, n-n1, p, f, 0, fin.NrBins, &pulseData[fin.NrBins*(p+fin.NrPols*f)], application.verbose_state) == 0) {
        printerror(application.verbose_state.debug, "ERROR pconv: Cannot write individual pulses.");
        return 0;
      }
@@ -300,7 +358,7 @@ int main(int argc, char **argv)
 void print_help()
 {
   fprintf(stdout, "Other options:\n");
-  fprintf(stdout, "  -memsave     Try to use less memory. Not all conversions will work with\n               or without this switch.\n");
+  fprintf(stdout, "  -memsave     Try to use less memory. Not all conversions will work with\n               or without this switch. Preprocess options are applied in blocks of\n               subints, which excludes options such as -TSCR and -align.\n");
   fprintf(stdout, "\n");
   printf("\n");
   printCitationInfo();
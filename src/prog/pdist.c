@@ -42,6 +42,10 @@ int main(int argc, char **argv)
   application.switch_device = 1;
   application.switch_cmap = 1;
   application.switch_cmaplist = 1;
+  application.switch_packed = 1;
+  application.switch_halfprec = 1;
+  application.switch_subintcache = 1;
+  application.read_in_memory = 1;
   nrbins_specified = 0;
   nrbins_specifiedy = 0;
   dx_specified = 0;
@@ -50,6 +54,8 @@ int main(int argc, char **argv)
   output_fraction = 0;
   read_log = 0;
   twoDmode = 0;
+  min_y_data = 0;
+  max_y_data = 0;
   centered_at_zero = 1;
   extra_phase = 0;
   showGraphics = 0;
@@ -369,6 +375,7 @@ int main(int argc, char **argv)
       return 0;
     }
     if(application.iformat > 0) {
+      int read_in_memory;
       verbose_definition verbose;
       cleanVerboseState(&verbose);
       copyVerboseState(application.verbose_state, &verbose);
@@ -376,7 +383,17 @@ int main(int argc, char **argv)
  if(verbose.debug == 0)
    verbose.verbose = 0;
       }
-      i = openPSRData(&datain, filename_ptr, application.iformat, 0, 1, 1, verbose);
+      read_in_memory = application.read_in_memory;
+      if(read_in_memory == 0 && isRandomAccessPSRDATA_format(application.iformat) == 0) {
+ printwarning(application.verbose_state.debug, "WARNING pdist: The format of %s cannot be read subint by subint, the data is loaded in memory instead.", filename_ptr);
+ read_in_memory = 1;
+      }
+      i = openPSRData(&datain, filename_ptr, application.iformat, 0, read_in_memory, 1, verbose);
+      if(i != 0 && read_in_memory == 0) {
+ i = readHeaderPSRData(&datain, 0, 1, verbose);
+ if(i != 0 && application.subintcache > 0)
+   i = enableSubintCachePSRData(&datain, application.subintcache*1048576, verbose);
+      }
       if(i == 0) {
  printerror(application.verbose_state.debug, "ERROR pdist: Error opening data");
  return 0;
@@ -399,8 +416,10 @@ int main(int argc, char **argv)
  printf(" times two input polarizations");
       printf("\n");
       data_x = malloc(datain.NrSubints*datain.NrFreqChan*datain.NrBins*sizeof(double));
-      data_y = malloc(datain.NrSubints*datain.NrFreqChan*datain.NrBins*sizeof(double));
-      if(data_x == NULL || data_y == NULL) {
+      data_y = NULL;
+      if(twoDmode || select || cdf)
+ data_y = malloc(datain.NrSubints*datain.NrFreqChan*datain.NrBins*sizeof(double));
+      if(data_x == NULL || ((twoDmode || select || cdf) && data_y == NULL)) {
  printerror(application.verbose_state.debug, "ERROR pdist: Memory allocation error.\n");
  return 0;
       }
@@ -474,28 +493,29 @@ int main(int argc, char **argv)
     }else {
       int skiplines = 0;
       if(twoDmode) {
- if(application.verbose_state.verbose)
-   fprintf(stdout, "Loading x values from ascii file\n");
- if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &ndata, file_column1, 1.0, read_log, &data_x, &min_x_data, &max_x_data, NULL, application.verbose_state, 1) == 0) {
-   printerror(application.verbose_state.debug, "ERROR pdist: cannot load file.\n");
-   if(colspecified) {
-     printwarning(application.verbose_state.debug, "WARNING pdist: Using the -col option implies the input file is a simple ascii file. For penergy output (in mode 1), or an other recognized pulsar format, use the -pol option instead.\n");
-   }
-   return 0;
- }
- if(application.verbose_state.verbose)
-   fprintf(stdout, "Loading y values from ascii file\n");
+ double *columns[2], mincolumns[2], maxcolumns[2];
+ int colnums[2];
  if(file_column2_defined == 0) {
    printerror(application.verbose_state.debug, "In 2D mode, two input columns should be specified with the -col option.\n");
    return 0;
  }
- if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &ndata, file_column2, 1.0, read_log, &data_y, &min_y_data, &max_y_data, NULL, application.verbose_state, 1) == 0) {
+ if(application.verbose_state.verbose)
+   fprintf(stdout, "Loading x and y values from ascii file\n");
+ colnums[0] = file_column1;
+ colnums[1] = file_column2;
+ if(read_ascii_columns_double(filename_ptr, skiplines, '#', -1, 1, &ndata, 2, colnums, 1.0, read_log, columns, mincolumns, maxcolumns, NULL, application.verbose_state, 1) == 0) {
    printerror(application.verbose_state.debug, "ERROR pdist: cannot load file.\n");
    if(colspecified) {
      printwarning(application.verbose_state.debug, "WARNING pdist: Using the -col option implies the input file is a simple ascii file. For penergy output (in mode 1), or an other recognized pulsar format, use the -pol option instead.\n");
    }
    return 0;
  }
+ data_x = columns[0];
+ data_y = columns[1];
+ min_x_data = mincolumns[0];
+ max_x_data = maxcolumns[0];
+ min_y_data = mincolumns[1];
+ max_y_data = maxcolumns[1];
       }else {
  if(application.verbose_state.verbose)
    fprintf(stdout, "Loading values from ascii file\n");
@@ -44,6 +44,8 @@ int main(int argc, char **argv)
   application.oformat = FITS_format;
   application.switch_formatlist = 1;
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_forceUniformFreqLabelling = 1;
   application.switch_onpulse = 1;
@@ -220,7 +222,7 @@ int main(int argc, char **argv)
       printerror(application.verbose_state.debug, "ERROR penergy: Input file cannot be opened. Please check if file %s exists and otherwise specify the correct input format with the -iformat option if the format is supported, but not automatically recognized.\n\n", filename_ptr);
       return 0;
     }
-    if(openPSRData(&datain, filename_ptr, application.iformat, 0, 1, 0, application.verbose_state) == 0) {
+    if(openPSRData(&datain, filename_ptr, application.iformat, 0, 2, 0, application.verbose_state) == 0) {
       printerror(application.verbose_state.debug, "ERROR penergy: Error opening data");
       return 0;
     }
@@ -34,6 +34,8 @@ int main(int argc, char **argv)
   datafile_definition fin[MaxNrPolarizations], clone, fout;
   initApplication(&application, "pfold", "[options] inputfile");
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_formatlist = 1;
   application.switch_iformat = 1;
@@ -212,7 +214,7 @@ int main(int argc, char **argv)
     return 0;
   }
   closePSRData(&fin[0], 0, application.verbose_state);
-  if(!openPSRData(&fin[0], argv[argc-1], application.iformat, 0, 1, 0, application.verbose_state))
+  if(!openPSRData(&fin[0], argv[argc-1], application.iformat, 0, 2, 0, application.verbose_state))
     return 0;
   if(PSRDataHeader_parse_commandline(&fin[0], argc, argv, application.verbose_state) == 0)
     return 0;
@@ -39,6 +39,7 @@ int main(int argc, char **argv)
   application.switch_verbose = 1;
   application.switch_debug = 1;
   application.switch_filelist = 1;
+  application.switch_headercache = 1;
   nohead = 0;
   noweights = 1;
   showfootnotes = 1;
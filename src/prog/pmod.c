@@ -54,6 +54,8 @@ int main(int argc, char **argv)
   application.oformat = FITS_format;
   application.switch_formatlist = 1;
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_onpulse = 1;
   application.switch_onpulsef = 1;
@@ -117,6 +117,8 @@ int main(int argc, char **argv)
   datafile_definition fin;
   initApplication(&application, "pplot", "[options] inputfile(s)");
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_rebin = 1;
   application.switch_device = 1;
@@ -717,7 +719,7 @@ int main(int argc, char **argv)
    return 0;
  }
  closePSRData(&fin, 0, application.verbose_state);
- if(!openPSRData(&fin, inputfilename, iformat, 0, 1, 0, application.verbose_state)) {
+ if(!openPSRData(&fin, inputfilename, iformat, 0, application.read_in_memory, 0, application.verbose_state)) {
    printerror(application.verbose_state.debug, "ERROR pplot: Error opening file.\n");
    return 0;
  }
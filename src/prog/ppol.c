@@ -40,6 +40,8 @@ int main(int argc, char **argv)
   pgplot_options_definition pgplot_options;
   initApplication(&application, "ppol", "[options] inputfile(s)");
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_iformat = 1;
   application.switch_oformat = 1;
@@ -260,7 +262,7 @@ int main(int argc, char **argv)
       }
     }
     cleanPSRData(&dataout, application.verbose_state);
-    if(!openPSRData(&datain, filename_ptr, application.iformat, 0, 1, 0, application.verbose_state))
+    if(!openPSRData(&datain, filename_ptr, application.iformat, 0, 2, 0, application.verbose_state))
       return 0;
     if(application.verbose_state.verbose) {
       fflush(stdout);
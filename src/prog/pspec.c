@@ -38,6 +38,8 @@ int main(int argc, char **argv)
   verbose_definition noverbose;
   initApplication(&application, "pspec", "[options] inputfile");
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_formatlist = 1;
   application.switch_iformat = 1;
@@ -303,7 +305,7 @@ int main(int argc, char **argv)
     return 0;
   }
   closePSRData(&fin[0], 0, application.verbose_state);
-  if(!openPSRData(&fin[0], argv[argc-1], application.iformat, 0, 1, 0, application.verbose_state))
+  if(!openPSRData(&fin[0], argv[argc-1], application.iformat, 0, application.read_in_memory, 0, application.verbose_state))
     return 0;
   if(PSRDataHeader_parse_commandline(&fin[0], argc, argv, application.verbose_state) == 0)
     return 0;
@@ -38,6 +38,7 @@ int main(int argc, char **argv)
   initApplication(&application, "pstat", "[options] inputfile(s)");
   application.switch_libversions = 1;
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
   application.switch_debug = 1;
   file1_column1 = 0;
   file1_column2 = 0;
@@ -376,7 +377,7 @@ int main(int argc, char **argv)
   char *filename_ptr;
   double *input_array[6];
   long number_values[6];
-  int number_input_arrays;
+  int number_input_arrays, nrcolnums, colnums[3];
   number_input_arrays = 0;
   number_values[0] = 0;
   filename_ptr = getNextFilenameFromList(&application, argv, application.verbose_state);
@@ -384,29 +385,21 @@ int main(int argc, char **argv)
     printerror(application.verbose_state.debug, "ERROR pstat: Bug!");
     return 0;
   }
-  if(file1_column1) {
-    double min_x, max_x, avrg;
-    if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], file1_column1, 1.0, read_log, &input_array[number_input_arrays], &min_x, &max_x, &avrg, application.verbose_state, 0) == 0) {
+  nrcolnums = 0;
+  if(file1_column1)
+    colnums[nrcolnums++] = file1_column1;
+  if(file1_column2)
+    colnums[nrcolnums++] = file1_column2;
+  if(file1_column3)
+    colnums[nrcolnums++] = file1_column3;
+  if(nrcolnums > 0) {
+    if(read_ascii_columns_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], nrcolnums, colnums, 1.0, read_log, &input_array[number_input_arrays], NULL, NULL, NULL, application.verbose_state, 0) == 0) {
       printerror(application.verbose_state.debug, "ERROR pstat: cannot load file.\n");
       return 0;
     }
-    number_input_arrays++;
-  }
-  if(file1_column2) {
-    double min_x, max_x, avrg;
-    if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], file1_column2, 1.0, read_log, &input_array[number_input_arrays], &min_x, &max_x, &avrg, application.verbose_state, 0) == 0) {
-      printerror(application.verbose_state.debug, "ERROR pstat: cannot load file.\n");
-      return 0;
-    }
-    number_input_arrays++;
-  }
-  if(file1_column3) {
-    double min_x, max_x, avrg;
-    if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], file1_column3, 1.0, read_log, &input_array[number_input_arrays], &min_x, &max_x, &avrg, application.verbose_state, 0) == 0) {
-      printerror(application.verbose_state.debug, "ERROR pstat: cannot load file.\n");
-      return 0;
-    }
-    number_input_arrays++;
+    for(i = 1; i < nrcolnums; i++)
+      number_values[number_input_arrays+i] = number_values[number_input_arrays];
+    number_input_arrays += nrcolnums;
   }
   if(file2_column1 || file2_column2 || file2_column3) {
     filename_ptr = getNextFilenameFromList(&application, argv, application.verbose_state);
@@ -415,29 +408,21 @@ int main(int argc, char **argv)
       return 0;
     }
   }
-  if(file2_column1) {
-    double min_x, max_x, avrg;
-    if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], file2_column1, 1.0, read_log, &input_array[number_input_arrays], &min_x, &max_x, &avrg, application.verbose_state, 0) == 0) {
-      printerror(application.verbose_state.debug, "ERROR pstat: cannot load file.\n");
-      return 0;
-    }
-    number_input_arrays++;
-  }
-  if(file2_column2) {
-    double min_x, max_x, avrg;
-    if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], file2_column2, 1.0, read_log, &input_array[number_input_arrays], &min_x, &max_x, &avrg, application.verbose_state, 0) == 0) {
-      printerror(application.verbose_state.debug, "ERROR pstat: cannot load file.\n");
-      return 0;
-    }
-    number_input_arrays++;
-  }
-  if(file2_column3) {
-    double min_x, max_x, avrg;
-    if(read_ascii_column_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], file2_column3, 1.0, read_log, &input_array[number_input_arrays], &min_x, &max_x, &avrg, application.verbose_state, 0) == 0) {
+  nrcolnums = 0;
+  if(file2_column1)
+    colnums[nrcolnums++] = file2_column1;
+  if(file2_column2)
+    colnums[nrcolnums++] = file2_column2;
+  if(file2_column3)
+    colnums[nrcolnums++] = file2_column3;
+  if(nrcolnums > 0) {
+    if(read_ascii_columns_double(filename_ptr, skiplines, '#', -1, 1, &number_values[number_input_arrays], nrcolnums, colnums, 1.0, read_log, &input_array[number_input_arrays], NULL, NULL, NULL, application.verbose_state, 0) == 0) {
       printerror(application.verbose_state.debug, "ERROR pstat: cannot load file.\n");
       return 0;
     }
-    number_input_arrays++;
+    for(i = 1; i < nrcolnums; i++)
+      number_values[number_input_arrays+i] = number_values[number_input_arrays];
+    number_input_arrays += nrcolnums;
   }
   FILE *fout;
   if(output_idx) {
@@ -42,6 +42,8 @@ int main(int argc, char **argv)
   const gsl_rng_type *rand_num_gen_type;
   initApplication(&application, "rmsynth", "[options] inputfile");
   application.switch_verbose = 1;
+  application.switch_wisdom = 1;
+  application.switch_shiftkernel = 1;
   application.switch_debug = 1;
   application.switch_rebin = 1;
   application.switch_rot = 1;